@@ -1,10 +1,34 @@
+#include "column_writer.hpp"
+#include "csv.hpp"
+#include "csv_loader.hpp"
+#include "csv_tokenizer.hpp"
 #include "data_layouts.hpp"
+#include "FORColumn.hpp"
+#include "memory_policy.hpp"
+#include "memory_report.hpp"
+#include "parallel_scan.hpp"
+#include "perf_counter.hpp"
+#include "scan_kernels.hpp"
+#include "snapshot.hpp"
+#include "StringColumn.hpp"
+#include "zone_maps.hpp"
+#include <algorithm>
 #include <cassert>
 #include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
 #include <iomanip>
 #include <iostream>
+#include <iterator>
+#include <limits>
 #include <mutable/util/macro.hpp>
+#include <numeric>
 #include <sstream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
 
 
 #ifndef NDEBUG
@@ -14,8 +38,119 @@ constexpr int32_t NUM_TUPLES_RW = 5e6;
 #endif
 
 
-template<typename Layout>
-void benchmark_store(const char *name)
+/** Scans the attributes \p attrs, which are `INT(4)`s, of \p table with the generated scan kernel of the table's layout
+ * or, if there is none, the fallback, and sums up the values weighted by \p weights like the query of \p scan does. */
+void benchmark_compiled_scan(const char *name, const char *scan, const m::Table &table,
+                             const std::vector<std::size_t> &attrs, const std::vector<uint64_t> &weights)
+{
+    constexpr std::size_t CHUNK_SIZE = 1024;
+    std::vector<std::vector<int32_t>> chunks(attrs.size(), std::vector<int32_t>(CHUNK_SIZE));
+    std::vector<void*> outputs;
+    for (auto &chunk : chunks)
+        outputs.push_back(chunk.data());
+
+    using namespace std::chrono;
+    auto begin = steady_clock::now();
+    uint64_t checksum = 0;
+    bool is_generated = false;
+    const std::size_t num_rows = table.store().num_rows();
+    for (std::size_t row = 0; row < num_rows; row += CHUNK_SIZE) {
+        const std::size_t n = std::min(CHUNK_SIZE, num_rows - row);
+        is_generated = scan_columns(table.schema(), table.layout(), table.store().memory().addr(), row, n, attrs,
+                                    outputs.data());
+        for (std::size_t k = 0; k != attrs.size(); ++k) {
+            for (std::size_t i = 0; i != n; ++i)
+                checksum += chunks[k][i] * weights[k];
+        }
+    }
+    auto end = steady_clock::now();
+
+    std::cout << "milestone1," << scan << "_compiled," << name << ','
+              << duration_cast<milliseconds>(end - begin).count() << ','
+              << std::hex << checksum << std::dec << ',' << (is_generated ? "generated" : "fallback")
+              << '\n';
+}
+
+/** Scans the `INT(4)` attributes \p attrs of \p table with `read_columns_prefetched()` for prefetch distances of 0, 1,
+ * 2, 4, ..., 64 tuples, and sums up the values weighted by \p weights.  Only sweeps row layouts, whose wide strides
+ * defeat the hardware prefetchers. */
+void benchmark_prefetched_scan(const char *name, const char *scan, const m::Table &table,
+                               const std::vector<std::size_t> &attrs, const std::vector<uint64_t> &weights)
+{
+    if (table.layout().child().num_tuples() != 1)
+        return; // not a row layout
+
+    constexpr std::size_t CHUNK_SIZE = 1024;
+    std::vector<std::vector<int32_t>> chunks(attrs.size(), std::vector<int32_t>(CHUNK_SIZE));
+    std::vector<void*> outputs;
+    for (auto &chunk : chunks)
+        outputs.push_back(chunk.data());
+
+    const std::size_t num_rows = table.store().num_rows();
+    for (std::size_t distance : { 0, 1, 2, 4, 8, 16, 32, 64 }) {
+        using namespace std::chrono;
+        auto begin = steady_clock::now();
+        uint64_t checksum = 0;
+        for (std::size_t row = 0; row < num_rows; row += CHUNK_SIZE) {
+            const std::size_t n = std::min(CHUNK_SIZE, num_rows - row);
+            read_columns_prefetched(table.schema(), table.layout(), table.store().memory().addr(), row, n, attrs,
+                                    outputs.data(), distance);
+            for (std::size_t k = 0; k != attrs.size(); ++k) {
+                for (std::size_t i = 0; i != n; ++i)
+                    checksum += chunks[k][i] * weights[k];
+            }
+        }
+        auto end = steady_clock::now();
+
+        std::cout << "milestone1," << scan << "_prefetch," << name << ',' << distance << ','
+                  << duration_cast<milliseconds>(end - begin).count() << ','
+                  << std::hex << checksum << std::dec << '\n';
+    }
+}
+
+/** Scans the `INT(4)` attributes \p attrs of \p table with `parallel_scan()` using 1, 2, 4, ... threads up to the
+ * number of hardware threads, sums up the values weighted by \p weights, and reports the speedup over one thread. */
+void benchmark_parallel_scan(const char *name, const char *scan, const m::Table &table,
+                             const std::vector<std::size_t> &attrs, const std::vector<uint64_t> &weights)
+{
+    struct checksum
+    {
+        const std::vector<uint64_t> *weights;
+        uint64_t sum = 0;
+
+        void operator()(const void *const *columns, std::size_t n) {
+            for (std::size_t k = 0; k != weights->size(); ++k) {
+                auto values = static_cast<const int32_t*>(columns[k]);
+                for (std::size_t i = 0; i != n; ++i)
+                    sum += values[i] * (*weights)[k];
+            }
+        }
+    };
+
+    const unsigned max_threads = std::max(std::thread::hardware_concurrency(), 1U);
+    double single_threaded_ms = 0;
+    for (unsigned num_threads = 1; num_threads < 2 * max_threads; num_threads *= 2) {
+        num_threads = std::min(num_threads, max_threads);
+        using namespace std::chrono;
+        auto begin = steady_clock::now();
+        auto consumers = parallel_scan(table.schema(), table.layout(), table.store().memory().addr(),
+                                       table.store().num_rows(), attrs, num_threads, checksum{ &weights });
+        uint64_t sum = 0;
+        for (auto &c : consumers)
+            sum += c.sum;
+        const double ms = duration<double, std::milli>(steady_clock::now() - begin).count();
+        if (num_threads == 1)
+            single_threaded_ms = ms;
+
+        std::cout << "milestone1," << scan << "_parallel," << name << ',' << num_threads << ',' << ms << ','
+                  << single_threaded_ms / ms << ',' << std::hex << sum << std::dec << '\n';
+    }
+}
+
+/** Benchmarks the layout computed by a `Layout` constructed from \p args.  The memory of all stores is placed according
+ * to \p policy. */
+template<typename Layout, typename... Args>
+void benchmark_store_with_policy(const char *name, const MemoryPolicy &policy, Args&&... args)
 {
     /* Clear the catalog before starting a new benchmark. */
     m::Catalog::Clear();
@@ -30,13 +165,20 @@ void benchmark_store(const char *name)
     C.default_backend("WasmV8");
 
     /* Register our store and set as default store. */
-    C.register_data_layout(name, std::make_unique<Layout>(), name);
+    C.register_data_layout(name, std::make_unique<Layout>(std::forward<Args>(args)...), name);
     C.default_data_layout(name);
 
     /* Create database 'dbsys' and select it. */
     auto &DB = C.add_database(C.pool("dbsys"));
     C.set_database_in_use(DB);
 
+    /* Back a table with a store placed according to the memory policy. */
+    auto create_store = [&C, &policy, name](m::Table &table) {
+        table.store(C.create_store(table));
+        if (not policy.is_default() and not apply_memory_policy(table.store(), policy))
+            std::cerr << "warning: could not apply the memory policy of " << name << std::endl;
+    };
+
     /* Evaluate memory layout. */
     {
         /* Create a wide table to evaluate padding and alignment. */
@@ -53,13 +195,42 @@ void benchmark_store(const char *name)
         tbl_wide.push_back(C.pool("j_i2"), m::Type::Get_Integer(m::Type::TY_Vector, 2));
         tbl_wide.push_back(C.pool("k_b"),  m::Type::Get_Boolean(m::Type::TY_Vector));
         tbl_wide.push_back(C.pool("l_i2"), m::Type::Get_Integer(m::Type::TY_Vector, 2));
-        tbl_wide.store(C.create_store(tbl_wide));
-
-        tbl_wide.store(C.create_store(tbl_wide));
+        create_store(tbl_wide);
         tbl_wide.layout(C.data_layout().make(tbl_wide.schema()));
         auto &layout = tbl_wide.layout();
 
         std::cout << "milestone1,size," << name << ',' << (layout.stride_in_bits() / layout.child().num_tuples()) << '\n';
+        print_footprint_csv(std::cout, std::string("milestone1,memory,wide,") + name, tbl_wide.schema(),
+                            compute_footprint(tbl_wide.schema(), layout));
+    }
+
+    /* Evaluate memory layout of 'packages', once with plain and once with dictionary-encoded text attributes.  The code
+     * types are those chosen for the 3, 227, and 81 distinct values of `repo`, `licenses`, and `packager` in
+     * `arch-packages.csv`. */
+    for (bool encoded : { false, true }) {
+        auto text = [encoded](std::size_t length, unsigned code_size) -> const m::Type* {
+            if (encoded)
+                return m::Type::Get_Integer(m::Type::TY_Vector, code_size);
+            return m::Type::Get_Char(m::Type::TY_Vector, length);
+        };
+        auto &tbl = DB.add_table(C.pool(encoded ? "packages_dict" : "packages_plain"));
+        tbl.push_back(C.pool("id"),          m::Type::Get_Integer(m::Type::TY_Vector, 4));
+        tbl.push_back(C.pool("repo"),        text(10, 1));
+        tbl.push_back(C.pool("pkg_name"),    m::Type::Get_Char(m::Type::TY_Vector, 32));
+        tbl.push_back(C.pool("pkg_ver"),     m::Type::Get_Char(m::Type::TY_Vector, 20));
+        tbl.push_back(C.pool("description"), m::Type::Get_Char(m::Type::TY_Vector, 80));
+        tbl.push_back(C.pool("licenses"),    text(32, 2));
+        tbl.push_back(C.pool("size"),        m::Type::Get_Integer(m::Type::TY_Vector, 8));
+        tbl.push_back(C.pool("packager"),    text(32, 1));
+        create_store(tbl);
+        tbl.layout(C.data_layout().make(tbl.schema()));
+        auto &layout = tbl.layout();
+
+        std::cout << "milestone1,size_" << (encoded ? "packages_dict" : "packages") << ',' << name << ','
+                  << (layout.stride_in_bits() / layout.child().num_tuples()) << '\n';
+        print_footprint_csv(std::cout,
+                            std::string("milestone1,memory,") + (encoded ? "packages_dict," : "packages,") + name,
+                            tbl.schema(), compute_footprint(tbl.schema(), layout));
     }
 
     /* Evaluate read/write performance - full table scan. */
@@ -70,14 +241,16 @@ void benchmark_store(const char *name)
         table.push_back(C.pool("value0"), m::Type::Get_Integer(m::Type::TY_Vector, 4));
         table.push_back(C.pool("value1"), m::Type::Get_Integer(m::Type::TY_Vector, 4));
         table.push_back(C.pool("value2"), m::Type::Get_Integer(m::Type::TY_Vector, 4));
-        table.store(C.create_store(table));
-        table.layout(C.data_layout().make(table.schema()));
+        create_store(table);
+        table.layout(C.data_layout().make(table.schema(), NUM_TUPLES_RW));
 
         /* Get a handle on the backing store, create a writer, and an I/O tuple. */
         auto &store = table.store();
         m::StoreWriter W(store);
         m::Tuple tup(table.schema());
 
+        using namespace std::chrono;
+        auto t_write_begin = steady_clock::now();
         for (int32_t i = 0; i != NUM_TUPLES_RW; ++i) {
             /* Set tuple data (i, 2*i). */
             tup.set(0, i);
@@ -86,6 +259,43 @@ void benchmark_store(const char *name)
             tup.set(3, i<<1);
             W.append(tup);
         }
+        auto t_write_end = steady_clock::now();
+
+        /* Write the same tuples column-wise in one batch to a second table. */
+        auto &bulk_table = DB.add_table(C.pool("full_scan_bulk"));
+        for (const char *attr : { "key", "value0", "value1", "value2" })
+            bulk_table.push_back(C.pool(attr), m::Type::Get_Integer(m::Type::TY_Vector, 4));
+        create_store(bulk_table);
+        bulk_table.layout(C.data_layout().make(bulk_table.schema(), NUM_TUPLES_RW));
+        std::vector<int32_t> keys(NUM_TUPLES_RW), values(NUM_TUPLES_RW);
+        for (int32_t i = 0; i != NUM_TUPLES_RW; ++i) {
+            keys[i] = i;
+            values[i] = i<<1;
+        }
+        auto t_bulk_begin = steady_clock::now();
+        append_columns(bulk_table, NUM_TUPLES_RW, { { keys.data() }, { values.data() }, { values.data() },
+                                                    { values.data() } });
+        auto t_bulk_end = steady_clock::now();
+
+        const double tuple_ms = duration<double, std::milli>(t_write_end - t_write_begin).count();
+        const double bulk_ms = duration<double, std::milli>(t_bulk_end - t_bulk_begin).count();
+        std::cout << "milestone1,write," << name << ',' << tuple_ms << ',' << bulk_ms << ','
+                  << NUM_TUPLES_RW / tuple_ms / 1e3 << ',' << NUM_TUPLES_RW / bulk_ms / 1e3 << '\n';
+
+        /* Both tables must hold the same tuples. */
+        {
+            auto stmt = m::statement_from_string(diag, "SELECT key, value0, value1, value2 FROM full_scan_bulk;");
+            auto query = m::as<m::ast::SelectStmt>(std::move(stmt));
+            uint64_t checksum = 0;
+            auto op = std::make_unique<m::CallbackOperator>([&checksum](const m::Schema&, const m::Tuple &T) {
+                    checksum += T.get(0).as_i() * 3;
+                    checksum += T.get(1).as_i() * 5;
+                    checksum += T.get(2).as_i() * 7;
+                    checksum += T.get(3).as_i() * 11;
+            });
+            m::execute_query(diag, *query, std::move(op));
+            std::cout << "milestone1,full_scan_bulk," << name << ',' << std::hex << checksum << std::dec << '\n';
+        }
 
         auto stmt = m::statement_from_string(diag, "SELECT key, value0, value1, value2 FROM full_scan;");
         auto query = m::as<m::ast::SelectStmt>(std::move(stmt));
@@ -98,15 +308,21 @@ void benchmark_store(const char *name)
                 checksum += T.get(3).as_i() * 11;
         });
 
-        using namespace std::chrono;
+        auto dtlb_misses = PerfCounter::DTLB_Load_Misses();
         auto t_read_begin = steady_clock::now();
+        dtlb_misses.start();
         m::execute_query(diag, *query, std::move(op));
+        dtlb_misses.stop();
         auto t_read_end = steady_clock::now();
 
         std::cout << "milestone1,full_scan," << name << ','
                   << duration_cast<milliseconds>(t_read_end - t_read_begin).count() << ','
                   << std::hex << checksum << std::dec
                   << '\n';
+        if (dtlb_misses.available())
+            std::cout << "milestone1,dtlb_misses,full_scan," << name << ',' << dtlb_misses.read() << '\n';
+        benchmark_compiled_scan(name, "full_scan", table, { 0, 1, 2, 3 }, { 3, 5, 7, 11 });
+        benchmark_parallel_scan(name, "full_scan", table, { 0, 1, 2, 3 }, { 3, 5, 7, 11 });
     }
 
     /* Evaluate read/write performance - partial table scan. */
@@ -117,8 +333,8 @@ void benchmark_store(const char *name)
         table.push_back(C.pool("value0"), m::Type::Get_Integer(m::Type::TY_Vector, 4));
         table.push_back(C.pool("value1"), m::Type::Get_Integer(m::Type::TY_Vector, 4));
         table.push_back(C.pool("value2"), m::Type::Get_Integer(m::Type::TY_Vector, 4));
-        table.store(C.create_store(table));
-        table.layout(C.data_layout().make(table.schema()));
+        create_store(table);
+        table.layout(C.data_layout().make(table.schema(), NUM_TUPLES_RW));
 
         /* Get a handle on the backing store, create a writer, and an I/O tuple. */
         auto &store = table.store();
@@ -152,13 +368,448 @@ void benchmark_store(const char *name)
                   << duration_cast<milliseconds>(t_read_end - t_read_begin).count() << ','
                   << std::hex << checksum << std::dec
                   << '\n';
+        benchmark_compiled_scan(name, "partial_scan", table, { 0, 3 }, { 3, 5 });
+        benchmark_prefetched_scan(name, "partial_scan", table, { 0, 3 }, { 3, 5 });
+        benchmark_parallel_scan(name, "partial_scan", table, { 0, 3 }, { 3, 5 });
+    }
+
+    /* Evaluate read performance - scan of few narrow attributes next to wide, cold attributes. */
+    {
+        /* Create a table resembling 'packages' with 112 bytes of cold attributes per tuple.  The hot attributes `id` and
+         * `size` are at the same positions as `key` and `value2` in the partial scan table. */
+        constexpr std::size_t NUM_COLD = 14;
+        auto &table = DB.add_table(C.pool("packages"));
+        table.push_back(C.pool("id"),   m::Type::Get_Integer(m::Type::TY_Vector, 4));
+        table.push_back(C.pool("c0"),   m::Type::Get_Integer(m::Type::TY_Vector, 8));
+        table.push_back(C.pool("c1"),   m::Type::Get_Integer(m::Type::TY_Vector, 8));
+        table.push_back(C.pool("size"), m::Type::Get_Integer(m::Type::TY_Vector, 8));
+        for (std::size_t c = 2; c != NUM_COLD; ++c)
+            table.push_back(C.pool(("c" + std::to_string(c)).c_str()), m::Type::Get_Integer(m::Type::TY_Vector, 8));
+        create_store(table);
+        table.layout(C.data_layout().make(table.schema(), NUM_TUPLES_RW));
+
+        auto &store = table.store();
+        m::StoreWriter W(store);
+        m::Tuple tup(W.schema());
+
+        for (int32_t i = 0; i != NUM_TUPLES_RW; ++i) {
+            tup.set(0, i);
+            for (std::size_t c = 1; c != NUM_COLD + 2; ++c)
+                tup.set(c, int64_t(i));
+            tup.set(3, int64_t(i) << 10);
+            W.append(tup);
+        }
+
+        auto stmt = m::statement_from_string(diag, "SELECT id, size FROM packages;");
+        auto query = m::as<m::ast::SelectStmt>(std::move(stmt));
+
+        uint64_t checksum = 0;
+        auto op = std::make_unique<m::CallbackOperator>([&checksum](const m::Schema&, const m::Tuple &T) {
+                checksum += T.get(0).as_i() * 3;
+                checksum += T.get(1).as_i() * 5;
+        });
+
+        auto dtlb_misses = PerfCounter::DTLB_Load_Misses();
+        using namespace std::chrono;
+        auto t_read_begin = steady_clock::now();
+        dtlb_misses.start();
+        m::execute_query(diag, *query, std::move(op));
+        dtlb_misses.stop();
+        auto t_read_end = steady_clock::now();
+
+        std::cout << "milestone1,hot_scan," << name << ','
+                  << duration_cast<milliseconds>(t_read_end - t_read_begin).count() << ','
+                  << std::hex << checksum << std::dec
+                  << '\n';
+        if (dtlb_misses.available())
+            std::cout << "milestone1,dtlb_misses,hot_scan," << name << ',' << dtlb_misses.read() << '\n';
+
+        /* Evaluate point accesses - fetch `id` and `size` of random tuples by id, like an index lookup would, reading
+         * the store memory directly.  Tuple `i` has id `i`.  Count the cache lines every lookup touches. */
+        constexpr std::size_t NUM_LOOKUPS = 1e6;
+        constexpr uint64_t LINE = 64 * 8;
+        struct lookup { uint64_t id_offset; uint64_t size_offset; };
+        std::vector<lookup> lookups(NUM_LOOKUPS);
+        std::size_t num_lines = 0, num_crossing = 0;
+        const auto id_path = compute_attribute_path(table.layout(), 0);
+        const auto size_path = compute_attribute_path(table.layout(), 3);
+        uint64_t state = 42;
+        for (auto &l : lookups) {
+            state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+            const std::size_t row = (state >> 33) % NUM_TUPLES_RW;
+            l.id_offset = id_path.offset_in_bits(row);
+            l.size_offset = size_path.offset_in_bits(row);
+
+            const uint64_t id_first = l.id_offset / LINE, id_last = (l.id_offset + 31) / LINE;
+            const uint64_t size_first = l.size_offset / LINE, size_last = (l.size_offset + 63) / LINE;
+            std::size_t lines = (id_last - id_first + 1) + (size_last - size_first + 1);
+            if (size_first <= id_last and id_first <= size_last) // the attributes share lines
+                lines = std::max(id_last, size_last) - std::min(id_first, size_first) + 1;
+            num_lines += lines;
+            num_crossing += lines > 1;
+        }
+
+        const auto memory = static_cast<const uint8_t*>(store.memory().addr());
+        checksum = 0;
+        t_read_begin = steady_clock::now();
+        for (auto &l : lookups) {
+            int32_t id;
+            int64_t size;
+            std::memcpy(&id, memory + l.id_offset / 8, sizeof(id));
+            std::memcpy(&size, memory + l.size_offset / 8, sizeof(size));
+            checksum += id * 3 + size * 5;
+        }
+        t_read_end = steady_clock::now();
+
+        std::cout << "milestone1,point_access," << name << ','
+                  << duration_cast<microseconds>(t_read_end - t_read_begin).count() << ','
+                  << double(num_lines) / NUM_LOOKUPS << ',' << double(num_crossing) / NUM_LOOKUPS << ','
+                  << std::hex << checksum << std::dec
+                  << '\n';
+    }
+
+    /* Evaluate read performance - selective scan, like `resource/query.sql`.  Package sizes are below 16 MiB except for
+     * a handful of packages larger than 1 GiB. */
+    {
+        constexpr int64_t THRESHOLD = 1024 * 1024 * 1024;
+        auto &table = DB.add_table(C.pool("selective_scan"));
+        table.push_back(C.pool("id"),   m::Type::Get_Integer(m::Type::TY_Vector, 4));
+        table.push_back(C.pool("size"), m::Type::Get_Integer(m::Type::TY_Vector, 8));
+        create_store(table);
+        table.layout(C.data_layout().make(table.schema(), NUM_TUPLES_RW));
+
+        auto &store = table.store();
+        m::StoreWriter W(store);
+        m::Tuple tup(W.schema());
+
+        /* The synopses of the zone map layout must be maintained alongside mutable's appends. */
+        std::unique_ptr<ZoneMaps> Z;
+        if constexpr (std::is_same_v<Layout, MyPAXZoneMapLayoutFactory>)
+            Z = std::make_unique<ZoneMaps>(table);
+
+        uint64_t state = 42;
+        for (int32_t i = 0; i != NUM_TUPLES_RW; ++i) {
+            state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+            tup.set(0, i);
+            tup.set(1, i % (1 << 20) == 1000 ? 2 * THRESHOLD : int64_t((state >> 32) % (16 << 20)));
+            W.append(tup);
+            if (Z)
+                Z->update(i);
+        }
+
+        auto stmt = m::statement_from_string(diag, "SELECT id, size FROM selective_scan WHERE size > 1073741824;");
+        auto query = m::as<m::ast::SelectStmt>(std::move(stmt));
+
+        uint64_t checksum = 0;
+        auto op = std::make_unique<m::CallbackOperator>([&checksum](const m::Schema&, const m::Tuple &T) {
+                checksum += T.get(0).as_i() * 3;
+                checksum += T.get(1).as_i() * 5;
+        });
+
+        using namespace std::chrono;
+        auto t_read_begin = steady_clock::now();
+        m::execute_query(diag, *query, std::move(op));
+        auto t_read_end = steady_clock::now();
+
+        std::cout << "milestone1,selective_scan," << name << ','
+                  << duration_cast<milliseconds>(t_read_end - t_read_begin).count() << ','
+                  << std::hex << checksum << std::dec
+                  << '\n';
+
+        if (Z) {
+            checksum = 0;
+            t_read_begin = steady_clock::now();
+            auto stats = Z->scan(1, THRESHOLD + 1, std::numeric_limits<int64_t>::max(), NUM_TUPLES_RW,
+                                 [&checksum, &Z](std::size_t row) {
+                                     checksum += Z->get_integer(row, 0) * 3;
+                                     checksum += Z->get_integer(row, 1) * 5;
+                                 });
+            t_read_end = steady_clock::now();
+
+            std::cout << "milestone1,selective_scan_zone_maps," << name << ','
+                      << duration_cast<milliseconds>(t_read_end - t_read_begin).count() << ','
+                      << stats.num_skipped << ',' << stats.num_blocks << ','
+                      << std::hex << checksum << std::dec
+                      << '\n';
+        }
+    }
+}
+
+template<typename Layout, typename... Args>
+void benchmark_store(const char *name, Args&&... args)
+{
+    benchmark_store_with_policy<Layout>(name, MemoryPolicy(), std::forward<Args>(args)...);
+}
+
+/** Evaluates decode throughput of frame-of-reference encoded integer columns, resembling `id` and `size` of
+ * 'packages'. */
+template<typename T>
+void benchmark_for_decode(const char *name, const std::vector<T> &values)
+{
+    auto column = FORColumn<T>::Encode(values.begin(), values.end());
+    std::vector<T> decoded(column.size());
+
+    using namespace std::chrono;
+    auto t_begin = steady_clock::now();
+    column.decode(decoded.data());
+    auto t_end = steady_clock::now();
+
+    uint64_t checksum = 0;
+    for (auto v : decoded)
+        checksum += v;
+    M_insist(std::equal(decoded.begin(), decoded.end(), values.begin()), "decoding must yield the original values");
+
+    std::cout << "milestone1,for_decode," << name << ','
+              << duration_cast<microseconds>(t_end - t_begin).count() << ','
+              << column.size_in_bytes() << ',' << values.size() * sizeof(T) << ','
+              << std::hex << checksum << std::dec
+              << '\n';
+}
+
+/** Evaluates size and scan performance of strings stored in fixed-size `CHAR(n)` slots versus a `StringColumn`.  The
+ * strings resemble `pkg_name CHAR(32)` and `description CHAR(80)` of 'packages'. */
+void benchmark_strings()
+{
+    uint64_t state = 42;
+    auto random = [&state](uint64_t bound) {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        return (state >> 33) % bound;
+    };
+    auto random_word = [&random](std::size_t length) {
+        std::string word;
+        for (std::size_t i = 0; i != length; ++i)
+            word += char('a' + random(26));
+        return word;
+    };
+
+    const char *name_prefixes[] = { "lib", "python-", "perl-", "haskell-", "linux", "xorg-", "ttf-", "r-", "" };
+    std::vector<std::string> pkg_names, descriptions;
+    for (int32_t i = 0; i != NUM_TUPLES_RW; ++i) {
+        pkg_names.push_back((name_prefixes[random(std::size(name_prefixes))] + random_word(3 + random(16))).substr(0, 32));
+        std::string description;
+        const std::size_t length = 20 + random(60);
+        while (description.size() < length)
+            description += random_word(2 + random(8)) + ' ';
+        descriptions.push_back(description.substr(0, length));
+    }
+
+    /* Stores \p strings as `CHAR(n)`, padded with NUL bytes, and as `StringColumn`. */
+    auto store = [](const std::vector<std::string> &strings, std::size_t n) {
+        std::pair<std::vector<char>, StringColumn<>> stored;
+        stored.first.resize(strings.size() * n);
+        for (std::size_t i = 0; i != strings.size(); ++i) {
+            std::memcpy(stored.first.data() + i * n, strings[i].data(), strings[i].size());
+            stored.second.append(strings[i]);
+        }
+        return stored;
+    };
+    auto [pkg_name_chars, pkg_name_column] = store(pkg_names, 32);
+    auto [description_chars, description_column] = store(descriptions, 80);
+
+    std::cout << "milestone1,string_size,pkg_name,char," << pkg_name_chars.size() / NUM_TUPLES_RW << '\n'
+              << "milestone1,string_size,pkg_name,string_column,"
+              << double(pkg_name_column.size_in_bytes()) / NUM_TUPLES_RW << '\n'
+              << "milestone1,string_size,description,char," << description_chars.size() / NUM_TUPLES_RW << '\n'
+              << "milestone1,string_size,description,string_column,"
+              << double(description_column.size_in_bytes()) / NUM_TUPLES_RW << '\n';
+
+    /* Scans `pkg_name` with an equality predicate on an existing name and with `LIKE 'python-%'`. */
+    const std::string needle = pkg_names[NUM_TUPLES_RW / 2];
+    const std::string_view prefix = "python-";
+    using namespace std::chrono;
+    auto report = [](const char *scan, const char *layout, auto begin, auto end, std::size_t num_matches) {
+        std::cout << "milestone1,string_scan," << scan << ',' << layout << ','
+                  << duration_cast<microseconds>(end - begin).count() << ',' << num_matches << '\n';
+    };
+    {
+        char padded[32] = { 0 };
+        std::memcpy(padded, needle.data(), needle.size());
+        std::size_t num_matches = 0;
+        auto begin = steady_clock::now();
+        for (int32_t i = 0; i != NUM_TUPLES_RW; ++i)
+            num_matches += std::memcmp(pkg_name_chars.data() + i * 32, padded, 32) == 0;
+        report("equal", "char", begin, steady_clock::now(), num_matches);
+    }
+    {
+        std::size_t num_matches = 0;
+        auto begin = steady_clock::now();
+        for (int32_t i = 0; i != NUM_TUPLES_RW; ++i)
+            num_matches += pkg_name_column.equals(i, needle);
+        report("equal", "string_column", begin, steady_clock::now(), num_matches);
+    }
+    {
+        std::size_t num_matches = 0;
+        auto begin = steady_clock::now();
+        for (int32_t i = 0; i != NUM_TUPLES_RW; ++i)
+            num_matches += std::memcmp(pkg_name_chars.data() + i * 32, prefix.data(), prefix.size()) == 0;
+        report("like_prefix", "char", begin, steady_clock::now(), num_matches);
+    }
+    {
+        std::size_t num_matches = 0;
+        auto begin = steady_clock::now();
+        for (int32_t i = 0; i != NUM_TUPLES_RW; ++i)
+            num_matches += pkg_name_column.starts_with(i, prefix);
+        report("like_prefix", "string_column", begin, steady_clock::now(), num_matches);
+    }
+}
+
+/** Evaluates the throughput of loading a CSV file resembling `arch-packages.csv`, with quoted descriptions containing
+ * delimiters and quotes, with mutable's loader and with `load_CSV_parallel()` for increasing numbers of threads. */
+void benchmark_ingest()
+{
+    const auto csv_file = std::filesystem::temp_directory_path() / "milestone1_ingest.csv";
+    {
+        std::ofstream out(csv_file);
+        write_CSV_record(out, { "id", "repo", "pkg_name", "pkg_ver", "description", "licenses", "size", "packager" });
+        uint64_t state = 42;
+        for (int32_t i = 0; i != NUM_TUPLES_RW; ++i) {
+            state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+            write_CSV_record(out, {
+                std::to_string(i), i % 3 ? "extra" : "core", "pkg" + std::to_string(state % 100000),
+                std::to_string(state % 10) + '.' + std::to_string(state % 7) + "-1",
+                i % 5 ? "A library for things, and more" : "Tools, with a \"quoted\" word",
+                "GPL", std::to_string((state >> 32) % (16 << 20)), "Some Packager <packager@archlinux.org>"
+            });
+        }
+    }
+    const double size_in_MB = std::filesystem::file_size(csv_file) / 1e6;
+
+    /* Measure the throughput of splitting the file into fields alone, byte by byte and with the SIMD tokenizer. */
+    {
+        std::ifstream in(csv_file, std::ios::binary);
+        const std::string csv((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        auto tokenize = [&](const char *name, auto count_fields) {
+            using namespace std::chrono;
+            auto begin = steady_clock::now();
+            const std::size_t num_fields = count_fields();
+            const double seconds = duration<double>(steady_clock::now() - begin).count();
+            std::cout << "milestone1,tokenize," << name << ',' << seconds * 1e3 << ',' << size_in_MB / seconds << ','
+                      << num_fields << '\n';
+        };
+        tokenize("scalar", [&]() {
+            std::size_t num_fields = 0;
+            bool quoted = false;
+            for (char c : csv) {
+                if (c == '"')
+                    quoted = not quoted;
+                else if (not quoted and (c == ',' or c == '\n'))
+                    ++num_fields;
+            }
+            return num_fields;
+        });
+        tokenize("simd", [&]() {
+            std::size_t num_fields = 0;
+            for (CSV_tokenizer tokenizer(csv.data(), csv.data() + csv.size()); tokenizer.has_next(); tokenizer.next())
+                ++num_fields;
+            return num_fields;
+        });
     }
+
+    /* Creates an empty table 'packages' in PAX layout. */
+    auto create_table = [&]() -> m::Table & {
+        m::Catalog::Clear();
+        auto &C = m::Catalog::Get();
+        auto &DB = C.add_database(C.pool("ingest"));
+        C.set_database_in_use(DB);
+
+        auto &T = DB.add_table(C.pool("packages"));
+        T.push_back(C.pool("id"),          m::Type::Get_Integer(m::Type::TY_Vector, 4));
+        T.push_back(C.pool("repo"),        m::Type::Get_Char(m::Type::TY_Vector, 10));
+        T.push_back(C.pool("pkg_name"),    m::Type::Get_Char(m::Type::TY_Vector, 32));
+        T.push_back(C.pool("pkg_ver"),     m::Type::Get_Char(m::Type::TY_Vector, 20));
+        T.push_back(C.pool("description"), m::Type::Get_Char(m::Type::TY_Vector, 80));
+        T.push_back(C.pool("licenses"),    m::Type::Get_Char(m::Type::TY_Vector, 32));
+        T.push_back(C.pool("size"),        m::Type::Get_Integer(m::Type::TY_Vector, 8));
+        T.push_back(C.pool("packager"),    m::Type::Get_Char(m::Type::TY_Vector, 32));
+        T.store(C.create_store(T));
+        const MyPAX4kLayoutFactory factory;
+        T.layout(static_cast<const m::storage::DataLayoutFactory&>(factory).make(T.schema()));
+        return T;
+    };
+
+    auto load = [&](unsigned num_threads, bool vectorized) -> m::Table & {
+        m::Diagnostic diag(true, std::cout, std::cerr);
+        auto &T = create_table();
+
+        using namespace std::chrono;
+        auto begin = steady_clock::now();
+        if (num_threads)
+            load_CSV_parallel(T, csv_file, num_threads, true, ',', '"', '\\', vectorized);
+        else
+            m::load_from_CSV(diag, T, csv_file, std::numeric_limits<std::size_t>::max(), true, false);
+        const double seconds = duration<double>(steady_clock::now() - begin).count();
+
+        const char *name = num_threads ? (vectorized ? "parallel_simd" : "parallel") : "mutable";
+        std::cout << "milestone1,ingest," << name << ',' << num_threads << ','
+                  << seconds * 1e3 << ',' << size_in_MB / seconds << ',' << NUM_TUPLES_RW / seconds << '\n';
+        return T;
+    };
+
+    load(0, false);
+    const unsigned max_threads = std::max(std::thread::hardware_concurrency(), 1U);
+    for (unsigned num_threads = 1; num_threads < 2 * max_threads; num_threads *= 2) {
+        load(std::min(num_threads, max_threads), false);
+        load(std::min(num_threads, max_threads), true);
+    }
+
+    /* Warm start: restore the loaded table from a snapshot, once with and once without verifying its checksum. */
+    const auto snapshot_file = std::filesystem::temp_directory_path() / "milestone1_ingest.snap";
+    write_snapshot(load(max_threads, true), snapshot_file);
+    for (bool verify : { true, false }) {
+        auto &T = create_table();
+        using namespace std::chrono;
+        auto begin = steady_clock::now();
+        open_snapshot(T, snapshot_file, verify);
+        const double seconds = duration<double>(steady_clock::now() - begin).count();
+        std::cout << "milestone1,ingest," << (verify ? "snapshot" : "snapshot_unverified") << ",1," << seconds * 1e3
+                  << ',' << size_in_MB / seconds << ',' << NUM_TUPLES_RW / seconds << '\n';
+    }
+    std::filesystem::remove(snapshot_file);
+    std::filesystem::remove(csv_file);
 }
 
 int main()
 {
+    {
+        std::vector<int32_t> ids(NUM_TUPLES_RW);
+        std::iota(ids.begin(), ids.end(), 1);
+        benchmark_for_decode("id", ids);
+
+        /* Package sizes are mostly below 16 MiB. */
+        std::vector<int64_t> sizes(NUM_TUPLES_RW);
+        uint64_t state = 42;
+        for (auto &size : sizes) {
+            state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+            size = (state >> 32) % (16 << 20);
+        }
+        benchmark_for_decode("size", sizes);
+    }
+    benchmark_strings();
+    benchmark_ingest();
+
+
     benchmark_store<MyNaiveRowLayoutFactory>("row_naive");
     benchmark_store<MyOptimizedRowLayoutFactory>("row_optimized");
+    /* All benchmark tables are free of NULL values. */
+    benchmark_store<MyOptimizedRowLayoutFactory>("row_optimized_notnull", false);
+    benchmark_store<MyPackedRowLayoutFactory>("row_packed");
+    /* Attributes 0 and 3 are hot, i.e. `id` and `size` of the point accesses. */
+    benchmark_store<MyCacheAlignedRowLayoutFactory>("row_cache_aligned", std::vector<std::size_t>{ 0, 3 });
     benchmark_store<MyPAX4kLayoutFactory>("pax");
+    benchmark_store<MyPAXZoneMapLayoutFactory>("pax_zone_maps");
+    benchmark_store<MyDSMLayoutFactory>("dsm");
+    /* Sweep the PAX block size. */
+    benchmark_store<MyPAXLayoutFactory>("pax16k", 16 * 1024);
+    benchmark_store<MyPAXLayoutFactory>("pax64k", 64 * 1024);
+    benchmark_store<MyPAXLayoutFactory>("pax256k", 256 * 1024);
+    benchmark_store<MyPAXLayoutFactory>("pax2M", 2 * 1024 * 1024);
+    benchmark_store<MyPAXAutoLayoutFactory>("pax_auto");
+    /* Attributes 0 and 3 are hot, i.e. `key` and `value2` of the partial scan and `id` and `size` of the hot scan. */
+    benchmark_store<MyHybridLayoutFactory>("hybrid", std::vector<double>{ 1., 0., 0., 1. });
+    /* Back the stores with transparent huge pages to reduce TLB misses, and interleave them on NUMA hosts. */
+    auto huge = MemoryPolicy::Parse(num_numa_nodes() > 1 ? "huge,interleave" : "huge");
+    benchmark_store_with_policy<MyOptimizedRowLayoutFactory>("row_optimized_huge", huge);
+    benchmark_store_with_policy<MyPAX4kLayoutFactory>("pax_huge", huge);
+    benchmark_store_with_policy<MyDSMLayoutFactory>("dsm_huge", huge);
     m::Catalog::Destroy();
 }
@@ -5,7 +5,9 @@
 #include <iomanip>
 #include <iostream>
 #include <random>
+#include <span>
 #include <sstream>
+#include <thread>
 #include <vector>
 
 
@@ -143,6 +145,102 @@ void benchmark(
                   << std::round(ns / double(num_point_lookups)) << ','
                   << std::hex << checksum << std::dec
                   << '\n';
+
+        /* Lookups with `find_batch()`, in batches of `batch_size` keys.  The keys are drawn anew, such that the
+         * batches do not profit from the nodes cached by the lookups before. */
+        for (const std::size_t batch_size : { 8UL, 32UL, 128UL }) {
+            const auto batch_keys = draw_lookup_keys(keys, misses, hit_ratio, num_point_lookups, g);
+            std::vector<typename tree_type::const_iterator> out(batch_size);
+            checksum = 0;
+
+            const auto t_batch_begin = steady_clock::now();
+            for (std::size_t i = 0; i < batch_keys.size(); i += batch_size) {
+                const std::size_t n = std::min(batch_size, batch_keys.size() - i);
+                tree.find_batch(std::span(batch_keys).subspan(i, n), std::span(out).first(n));
+                for (std::size_t j = 0; j != n; ++j) {
+                    const uint64_t v = (out[j] == tree.cend()) ? 1UL : (*out[j]).second();
+                    checksum = (checksum << 3UL) ^ v;
+                }
+            }
+            const auto t_batch_end = steady_clock::now();
+
+            const auto ns = duration_cast<nanoseconds>(t_batch_end - t_batch_begin).count();
+            std::cout << "milestone2,find_" << name << '_' << unsigned(100 * hit_ratio) << "_batch" << batch_size
+                      << ',' << std::round(ns / double(num_point_lookups)) << ','
+                      << std::hex << checksum << std::dec
+                      << '\n';
+        }
+    }
+
+    /*----- Benchmark concurrent `find()`s. -----*/
+    {
+        /* Every reader looks up all keys, starting at a different offset.  Reports the wall-clock time per lookup over
+         * all readers and the speedup of the throughput over a single reader. */
+        const auto lookup_keys = draw_lookup_keys(keys, misses, .95f, num_point_lookups, g);
+        const unsigned max_threads = std::max(1U, std::thread::hardware_concurrency());
+        double ns_single = 0;
+        for (unsigned num_threads = 1; ; num_threads = std::min(2 * num_threads, max_threads)) {
+            std::vector<uint64_t> checksums(num_threads, 0);
+            std::vector<std::thread> threads;
+
+            const auto t_lookup_begin = steady_clock::now();
+            for (unsigned t = 0; t != num_threads; ++t) {
+                threads.emplace_back([&tree, &lookup_keys, &checksums, t, num_threads]() {
+                    uint64_t checksum = 0;
+                    const std::size_t offset = t * lookup_keys.size() / num_threads;
+                    for (std::size_t i = 0; i != lookup_keys.size(); ++i) {
+                        const auto it = tree.find(lookup_keys[(offset + i) % lookup_keys.size()]);
+                        checksum += (it == tree.cend()) ? 1UL : (*it).second();
+                    }
+                    checksums[t] = checksum;
+                });
+            }
+            for (auto &thread : threads)
+                thread.join();
+            const auto t_lookup_end = steady_clock::now();
+
+            const double ns = duration_cast<nanoseconds>(t_lookup_end - t_lookup_begin).count() /
+                              double(num_threads * lookup_keys.size());
+            if (num_threads == 1)
+                ns_single = ns;
+            std::cout << "milestone2,find_parallel_" << name << '_' << num_threads << ','
+                      << std::round(ns) << ','
+                      << std::setprecision(3) << ns_single / ns << std::setprecision(6) << ','
+                      << std::hex << checksums.front() << std::dec
+                      << '\n';
+            if (num_threads == max_threads)
+                break;
+        }
+    }
+
+    /*----- Benchmark `insert()` and `erase()`. -----*/
+    {
+        /* Insert keys drawn from the data in random order into an empty tree, then erase them again. */
+        const auto insert_keys = draw_lookup_keys(keys, misses, 1.f, num_point_lookups, g);
+        auto dynamic_tree = tree_type::Bulkload(data.cend(), data.cend());
+
+        const auto t_insert_begin = steady_clock::now();
+        for (auto k : insert_keys)
+            dynamic_tree.insert(k, Value(k));
+        const auto t_insert_end = steady_clock::now();
+
+        std::cout << "milestone2,insert_" << name << ','
+                  << std::round(duration_cast<nanoseconds>(t_insert_end - t_insert_begin).count() /
+                                double(num_point_lookups)) << ','
+                  << dynamic_tree.height()
+                  << '\n';
+
+        std::size_t num_erased = 0;
+        const auto t_erase_begin = steady_clock::now();
+        for (auto k : insert_keys)
+            num_erased += dynamic_tree.erase(k);
+        const auto t_erase_end = steady_clock::now();
+
+        std::cout << "milestone2,erase_" << name << ','
+                  << std::round(duration_cast<nanoseconds>(t_erase_end - t_erase_begin).count() /
+                                double(num_point_lookups)) << ','
+                  << num_erased
+                  << '\n';
     }
 }
 
@@ -7,8 +7,17 @@
 #include <cassert>
 #include <concepts>
 #include <cstdint>
+#include <limits>
+#include <span>
+#include <tuple>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
+#if defined(__AVX512F__) || defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
 /** Require that \tparam T is an *orderable* type, i.e. that two instances of \tparam T can be compare_key_paird less than and
  * equals. */
 template <typename T>
@@ -62,24 +71,52 @@ struct BTree
     static constexpr size_type NODE_ALIGNMENT_IN_BYTES = NodeAlignmentInBytes;
 
 private:
+    static constexpr size_type align_up(size_type offset, size_type alignment)
+    {
+        return (offset + alignment - 1) / alignment * alignment;
+    }
+
+public:
+    /** The header shared by `Leaf` and `INode`.  Nodes are not polymorphic: the level tells the kind of a node, and
+     * the descent, which knows the level of every node it visits, casts statically. */
+    struct Node
+    {
+        uint16_t level;  ///< 0 for a `Leaf`, the height of the subtree for an `INode`
+        uint16_t length; ///< the number of entries
+    };
+
+private:
+    /** Returns the size of a node with a `Node` header, \p n keys, \p n payloads of \tparam Payload, and
+     * \p num_pointers pointers, laid out in this order. */
+    template <typename Payload>
+    static constexpr size_type node_size(size_type n, size_type num_pointers)
+    {
+        size_type size = sizeof(Node);
+        size = align_up(size, alignof(key_type)) + n * sizeof(key_type);
+        size = align_up(size, alignof(Payload)) + n * sizeof(Payload);
+        if (num_pointers)
+            size = align_up(size, alignof(void *)) + num_pointers * sizeof(void *);
+        return size;
+    }
+
     /** Computes the number of key-value pairs per `Leaf`, considering the specified `NodeSizeInBytes`. */
     static constexpr size_type compute_num_keys_per_leaf()
     {
         /* TODO 1.2.1 */
-        size_type pair_size = sizeof(key_type) + sizeof(mapped_type);
-        size_type usable = (NodeSizeInBytes - sizeof(size_t) - 2 * sizeof(Leaf *)) / pair_size;
-
-        return usable - 1;
+        size_type n = NodeSizeInBytes / (sizeof(key_type) + sizeof(mapped_type));
+        while (n > 1 and node_size<mapped_type>(n, 1) > NodeSizeInBytes)
+            --n;
+        return n;
     };
 
     /** Computes the number of keys per `INode`, considering the specified `NodeSizeInBytes`. */
     static constexpr size_type compute_num_keys_per_inode()
     {
         /* TODO 1.3.1 */
-        size_type pair_size = sizeof(key_type) + sizeof(Node_Entity *);
-        size_type usable = (NodeSizeInBytes - sizeof(size_t) - sizeof(BTree *)) / pair_size;
-
-        return usable - 1;
+        size_type n = NodeSizeInBytes / (sizeof(key_type) + sizeof(void *));
+        while (n > 2 and node_size<Node *>(n, 0) > NodeSizeInBytes)
+            --n;
+        return n;
     };
 
 public:
@@ -88,129 +125,72 @@ public:
     ///> the number of keys per `INode`
     static constexpr size_type NUM_KEYS_PER_INODE = compute_num_keys_per_inode();
 
-    struct Node_Entity
-    {
-        virtual key_type get_pivot() = 0;
-        virtual void find(const key_type &key) = 0;
-        virtual void lower_bound(const key_type &key) = 0;
-        virtual void upper_bound(const key_type &key) = 0;
-        virtual ~Node_Entity() = default;
-    };
+    static_assert(NUM_KEYS_PER_LEAF <= UINT16_MAX and NUM_KEYS_PER_INODE <= UINT16_MAX,
+                  "node capacity exceeds the range of `Node::length`");
 
     /** This class implements leaves of the B+-tree. */
-    struct alignas(NODE_ALIGNMENT_IN_BYTES) Leaf : public Node_Entity
+    struct alignas(NODE_ALIGNMENT_IN_BYTES) Leaf : Node
     {
         /* TODO 1.2.2 define fields */
         std::array<key_type, NUM_KEYS_PER_LEAF> keys;
         std::array<mapped_type, NUM_KEYS_PER_LEAF> vals;
-        size_t length = 0;
         Leaf *next = nullptr;
-        BTree *tree;
 
         /* TODO 1.2.3 define methods */
-        template <typename It>
-        Leaf(const It &begin, const It &end, BTree *Tree) : tree(Tree)
-        {
-            for (auto iter = begin; iter != end; iter++, length++)
-            {
-                keys[length] = (*iter).first;
-                vals[length] = (*iter).second;
-            }
-        }
+        Leaf() : Node{0, 0} {}
 
-        key_type get_pivot() override { return keys[length - 1]; }
-
-        void find(const key_type &key) override
+        template <typename It>
+        Leaf(const It &begin, const It &end) : Node{0, 0}
         {
-            if (std::binary_search(keys.begin(), keys.begin() + length, key))
+            for (auto iter = begin; iter != end; iter++, this->length++)
             {
-                auto it = std::lower_bound(keys.begin(), keys.begin() + length, key);
-                tree->find_iter = iterator(this, it - keys.begin());
-                return;
+                keys[this->length] = (*iter).first;
+                vals[this->length] = (*iter).second;
             }
-
-            tree->find_iter = iterator(this, -1);
-        }
-
-        void lower_bound(const key_type &key) override
-        {
-            auto it = std::lower_bound(keys.begin(), keys.begin() + length, key);
-
-            if (it == keys.begin() + length)
-                tree->lower_bound_iter = iterator(this, -1);
-            else
-                tree->lower_bound_iter = iterator(this, it - keys.begin());
         }
 
-        void upper_bound(const key_type &key) override
-        {
-            auto it = std::upper_bound(keys.begin(), keys.begin() + length, key);
-
-            if (it == keys.begin() + length)
-                tree->upper_bound_iter = iterator(this, -1);
-
-            else
-                tree->upper_bound_iter = iterator(this, it - keys.begin());
-        }
+        key_type get_pivot() const { return keys[this->length - 1]; }
     };
     static_assert(sizeof(Leaf) <= NODE_SIZE_IN_BYTES, "Leaf exceeds its size limit");
 
     /** This class implements inner nodes of the B+-tree. */
-    struct alignas(NODE_ALIGNMENT_IN_BYTES) INode : public Node_Entity
+    struct alignas(NODE_ALIGNMENT_IN_BYTES) INode : Node
     {
         /* TODO 1.3.2 define fields */
         std::array<key_type, NUM_KEYS_PER_INODE> keys;
-        std::array<Node_Entity *, NUM_KEYS_PER_INODE> node_ptrs;
-        size_t length = 0;
-        BTree *tree;
+        std::array<Node *, NUM_KEYS_PER_INODE> node_ptrs;
 
         /* TODO 1.3.3 define methods */
+        explicit INode(uint16_t level) : Node{level, 0} {}
+
+        /** Creates an `INode` with the children in the range from \p begin to \p end, which share a level. */
         template <typename It>
-        INode(const It &begin, const It &end, BTree *Tree) : tree(Tree)
+        INode(const It &begin, const It &end) : Node{uint16_t((*begin)->level + 1), 0}
         {
-            for (auto iter = begin; iter < end; iter++, length++)
+            for (auto iter = begin; iter < end; iter++, this->length++)
             {
-                node_ptrs[length] = *iter;
-                keys[length] = (*iter)->get_pivot();
+                node_ptrs[this->length] = *iter;
+                keys[this->length] = pivot(*iter);
             }
         }
 
-        key_type get_pivot() override { return keys[length - 1]; }
-
-        void find(const key_type &key) override
-        {
-            auto it = std::lower_bound(keys.begin(), keys.begin() + length, key);
-            if (it == keys.begin() + length)
-                tree->find_iter = iterator(nullptr, -1);
-            else
-                node_ptrs[it - keys.begin()]->find(key);
-        }
-
-        void lower_bound(const key_type &key) override
-        {
-            auto it = std::lower_bound(keys.begin(), keys.begin() + length, key);
-            if (it == keys.begin() + length)
-                tree->lower_bound_iter = iterator(nullptr, -1);
-            else
-                node_ptrs[it - keys.begin()]->lower_bound(key);
-        }
-
-        void upper_bound(const key_type &key) override
-        {
-            auto it = std::upper_bound(keys.begin(), keys.begin() + length, key);
-            if (it == keys.begin() + length)
-                tree->upper_bound_iter = iterator(nullptr, -1);
-            else
-                node_ptrs[it - keys.begin()]->upper_bound(key);
-        }
+        key_type get_pivot() const { return keys[this->length - 1]; }
     };
     static_assert(sizeof(INode) <= NODE_SIZE_IN_BYTES, "INode exceeds its size limit");
 
+    /** Returns the greatest key of the non-empty \p node. */
+    static key_type pivot(const Node *node)
+    {
+        return node->level == 0 ? static_cast<const Leaf *>(node)->get_pivot()
+                                : static_cast<const INode *>(node)->get_pivot();
+    }
+
 private:
     template <bool IsConst>
     struct the_iterator
     {
         friend struct BTree;
+        friend struct the_iterator<not IsConst>;
 
         static constexpr bool is_const = IsConst;
         using value_type = std::conditional_t<is_const, const mapped_type, mapped_type>;
@@ -220,14 +200,19 @@ private:
 
         /* TODO 1.4.3 define fields */
         leaf_type *current = nullptr;
-        int index = 0;
+        size_type index = 0;
 
     public:
         the_iterator(){};
 
-        the_iterator(Leaf *leafptr, int ind = 0) : current(leafptr), index(ind) {}
+        the_iterator(Leaf *leafptr, size_type ind = 0) : current(leafptr), index(ind) {}
 
-        the_iterator(the_iterator<false> other) : current(other.current), index(other.index) {}
+        /** Converts an `iterator` to a `const_iterator`. */
+        template <bool C = IsConst>
+            requires C
+        the_iterator(const the_iterator<false> &other) : current(other.current), index(other.index)
+        {
+        }
 
         bool operator==(the_iterator other) const
         {
@@ -254,7 +239,7 @@ private:
 
         the_iterator operator++(int)
         {
-            the_iterator copy(this);
+            the_iterator copy(*this);
             operator++();
             return copy;
         }
@@ -298,15 +283,11 @@ private:
 
     iterator begin_iter = iterator();
     iterator end_iter = iterator();
-    iterator find_iter = iterator();
-    iterator lower_bound_iter = iterator();
-    iterator upper_bound_iter = iterator();
 
     const_iterator const_begin_iter = const_iterator();
     const_iterator const_end_iter = const_iterator();
 
-    Node_Entity *root = nullptr;
-    std::vector<std::vector<Node_Entity *>> nodes;
+    Node *root = nullptr;
 
 public:
     /** Bulkloads the data in the range from `begin` (inclusive) to `end` (exclusive) into a fresh `BTree` and returns
@@ -319,15 +300,16 @@ public:
                  }
     {
         /* TODO 1.4.4 */
-        BTree<Key, Value, NodeSizeInBytes> tree(begin, end);
-        return tree;
+        return BTree(begin, end);
     }
 
+    BTree(const BTree &) = delete;
+    BTree &operator=(const BTree &) = delete;
+
     ~BTree()
     {
-        for (auto &level : nodes)
-            for (auto &node : level)
-                delete node;
+        if (root != nullptr)
+            destroy(root);
     }
 
 private:
@@ -340,25 +322,26 @@ private:
         if (tree_size % NUM_KEYS_PER_LEAF)
             NUM_LEAVES++;
 
-        nodes.push_back(std::vector<Node_Entity *>(NUM_LEAVES));
+        std::vector<std::vector<Node *>> nodes;
+        nodes.push_back(std::vector<Node *>(NUM_LEAVES));
 
         size_t ind = 0;
         while ((end - begin) > NUM_KEYS_PER_LEAF)
         {
-            nodes.back()[ind] = new Leaf(begin, begin + NUM_KEYS_PER_LEAF, this);
+            nodes.back()[ind] = new Leaf(begin, begin + NUM_KEYS_PER_LEAF);
             begin += NUM_KEYS_PER_LEAF;
             ind++;
         }
         if (end - begin > 0)
-            nodes.back()[ind] = new Leaf(begin, end, this);
+            nodes.back()[ind] = new Leaf(begin, end);
 
         if (NUM_LEAVES > 0)
-            root = build_tree();
+            root = build_tree(nodes);
     }
 
-    Node_Entity *build_tree()
+    Node *build_tree(std::vector<std::vector<Node *>> &nodes)
     {
-        std::vector<Node_Entity *> &leaves = nodes[0];
+        std::vector<Node *> &leaves = nodes[0];
 
         begin_iter = iterator(static_cast<Leaf *>(leaves[0]));
         const_begin_iter = const_iterator(static_cast<Leaf *>(leaves[0]));
@@ -379,28 +362,345 @@ private:
             if (nodes.back().size() % NUM_KEYS_PER_INODE)
                 NUM_NODES++;
 
-            nodes.push_back(std::vector<Node_Entity *>(NUM_NODES));
+            nodes.push_back(std::vector<Node *>(NUM_NODES));
 
             size_t ind = 0;
             while ((end - begin) > NUM_KEYS_PER_INODE)
             {
-                nodes.back()[ind] = new INode(begin, begin + NUM_KEYS_PER_INODE, this);
+                nodes.back()[ind] = new INode(begin, begin + NUM_KEYS_PER_INODE);
                 begin += NUM_KEYS_PER_INODE;
                 ind++;
             }
             if (end - begin > 0)
-                nodes.back()[ind] = new INode(begin, end, this);
+                nodes.back()[ind] = new INode(begin, end);
         }
 
+        tree_height = nodes.size() - 1;
         return nodes.back()[0];
     }
 
+    /** Deletes the subtree \p node. */
+    static void destroy(Node *node)
+    {
+        if (node->level == 0)
+        {
+            delete static_cast<Leaf *>(node);
+            return;
+        }
+        auto inode = static_cast<INode *>(node);
+        for (size_type i = 0; i != inode->length; ++i)
+            destroy(inode->node_ptrs[i]);
+        delete inode;
+    }
+
+    static auto &payloads(Leaf &leaf) { return leaf.vals; }
+    static auto &payloads(INode &inode) { return inode.node_ptrs; }
+
+    /** Inserts \p key and \p payload at position \p pos of \p node, which must not be full. */
+    template <typename Node, typename Payload>
+    static void insert_entry(Node &node, size_type pos, const key_type &key, Payload &&payload)
+    {
+        auto &vals = payloads(node);
+        std::move_backward(node.keys.begin() + pos, node.keys.begin() + node.length,
+                           node.keys.begin() + node.length + 1);
+        std::move_backward(vals.begin() + pos, vals.begin() + node.length, vals.begin() + node.length + 1);
+        node.keys[pos] = key;
+        vals[pos] = std::forward<Payload>(payload);
+        node.length++;
+    }
+
+    /** Removes the entry at position \p pos of \p node. */
+    template <typename Node>
+    static void erase_entry(Node &node, size_type pos)
+    {
+        auto &vals = payloads(node);
+        std::move(node.keys.begin() + pos + 1, node.keys.begin() + node.length, node.keys.begin() + pos);
+        std::move(vals.begin() + pos + 1, vals.begin() + node.length, vals.begin() + pos);
+        node.length--;
+    }
+
+    /** Moves the entries of \p node from position \p first on to the end of \p target. */
+    template <typename Node>
+    static void move_entries(Node &node, size_type first, Node &target)
+    {
+        std::move(node.keys.begin() + first, node.keys.begin() + node.length, target.keys.begin() + target.length);
+        std::move(payloads(node).begin() + first, payloads(node).begin() + node.length,
+                  payloads(target).begin() + target.length);
+        target.length += node.length - first;
+        node.length = first;
+    }
+
+    /** Inserts \p key and \p payload at position \p pos of the full \p node by moving the upper half of the entries,
+     * including the new one, to the empty \p sibling.  Both nodes hold at least half of the entries afterwards.
+     * Returns the node holding the new entry and its position. */
+    template <typename Node, typename Payload>
+    static std::pair<Node *, size_type> split_insert(Node &node, Node &sibling, size_type pos, const key_type &key,
+                                                     Payload &&payload)
+    {
+        const size_type num_left = (node.keys.size() + 2) / 2; // of the capacity plus the new entry
+        if (pos < num_left)
+        {
+            move_entries(node, num_left - 1, sibling);
+            insert_entry(node, pos, key, std::forward<Payload>(payload));
+            return {&node, pos};
+        }
+        move_entries(node, num_left, sibling);
+        insert_entry(sibling, pos - num_left, key, std::forward<Payload>(payload));
+        return {&sibling, pos - num_left};
+    }
+
+    /** Returns the rightmost leaf of the subtree \p node at \p level. */
+    static Leaf *rightmost_leaf(Node *node, size_type level)
+    {
+        for (; level != 0; --level)
+        {
+            auto inode = static_cast<INode *>(node);
+            node = inode->node_ptrs[inode->length - 1];
+        }
+        return static_cast<Leaf *>(node);
+    }
+
+    /** Inserts \p key and \p value into the subtree \p node at \p level, behind all pairs with the same key.  If
+     * \p assign and the subtree holds \p key, assigns \p value to the first pair with \p key instead and clears
+     * \p inserted.  Points \p pos to the pair.  Returns the new right sibling of \p node if it was split, and
+     * `nullptr` otherwise. */
+    Node *insert_into(Node *node, size_type level, const key_type &key, mapped_type &value, bool assign,
+                             iterator &pos, bool &inserted)
+    {
+        if (level == 0)
+        {
+            auto leaf = static_cast<Leaf *>(node);
+            auto first = leaf->keys.begin(), last = first + leaf->length;
+            auto it = assign ? std::lower_bound(first, last, key) : std::upper_bound(first, last, key);
+            const size_type i = it - first;
+            if (assign and it != last and *it == key)
+            {
+                leaf->vals[i] = std::move(value);
+                pos = iterator(leaf, i);
+                inserted = false;
+                return nullptr;
+            }
+
+            inserted = true;
+            if (leaf->length < NUM_KEYS_PER_LEAF)
+            {
+                insert_entry(*leaf, i, key, std::move(value));
+                pos = iterator(leaf, i);
+                return nullptr;
+            }
+            auto sibling = new Leaf();
+            auto [target, j] = split_insert(*leaf, *sibling, i, key, std::move(value));
+            sibling->next = leaf->next;
+            leaf->next = sibling;
+            pos = iterator(target, j);
+            return sibling;
+        }
+
+        /* Descend into the first child whose greatest key is not less (if `assign`) or greater than `key`. */
+        auto inode = static_cast<INode *>(node);
+        auto first = inode->keys.begin(), last = first + inode->length;
+        auto it = assign ? std::lower_bound(first, last, key) : std::upper_bound(first, last, key);
+        const size_type i = std::min<size_type>(it - first, inode->length - 1);
+        Node *child = inode->node_ptrs[i];
+        Node *child_sibling = insert_into(child, level - 1, key, value, assign, pos, inserted);
+        inode->keys[i] = pivot(child);
+        if (child_sibling == nullptr)
+            return nullptr;
+
+        if (inode->length < NUM_KEYS_PER_INODE)
+        {
+            insert_entry(*inode, i + 1, pivot(child_sibling), child_sibling);
+            return nullptr;
+        }
+        auto sibling = new INode(inode->level);
+        split_insert(*inode, *sibling, i + 1, pivot(child_sibling), child_sibling);
+        return sibling;
+    }
+
+    /** Erases the first pair with \p key from the subtree \p node at \p level.  \p left is the subtree at
+     * \p left_level left of \p node, if any.  Returns whether there was such a pair.  The children of \p node are
+     * rebalanced, \p node itself may underflow and is rebalanced by its parent. */
+    bool erase_from(Node *node, size_type level, const key_type &key, Node *left, size_type left_level)
+    {
+        if (level == 0)
+        {
+            auto leaf = static_cast<Leaf *>(node);
+            auto first = leaf->keys.begin(), last = first + leaf->length;
+            auto it = std::lower_bound(first, last, key);
+            if (it == last or not(*it == key))
+                return false;
+            erase_entry(*leaf, it - first);
+            return true;
+        }
+
+        auto inode = static_cast<INode *>(node);
+        auto first = inode->keys.begin(), last = first + inode->length;
+        const size_type i = std::min<size_type>(std::lower_bound(first, last, key) - first, inode->length - 1);
+        if (i != 0)
+        {
+            left = inode->node_ptrs[i - 1];
+            left_level = level - 1;
+        }
+        if (not erase_from(inode->node_ptrs[i], level - 1, key, left, left_level))
+            return false;
+
+        if (level == 1)
+            rebalance<Leaf>(*inode, i, left == nullptr ? nullptr : rightmost_leaf(left, left_level));
+        else
+            rebalance<INode>(*inode, i, nullptr);
+        return true;
+    }
+
+    /** Restores the minimum fill of the child \p i of \p parent by borrowing an entry from a sibling or by merging
+     * with a sibling, and updates the greatest keys in \p parent.  Deletes the child if it is empty and has no
+     * siblings, leaving \p parent empty.  \p prev is the leaf in front of the child, if it is a leaf. */
+    template <typename Node>
+    void rebalance(INode &parent, size_type i, Leaf *prev)
+    {
+        constexpr size_type MIN_LENGTH = (std::tuple_size_v<decltype(Node::keys)> + 1) / 2;
+        auto child = static_cast<Node *>(parent.node_ptrs[i]);
+        if (child->length >= MIN_LENGTH)
+        {
+            parent.keys[i] = child->get_pivot();
+            return;
+        }
+
+        auto left = i > 0 ? static_cast<Node *>(parent.node_ptrs[i - 1]) : nullptr;
+        auto right = i + 1 < parent.length ? static_cast<Node *>(parent.node_ptrs[i + 1]) : nullptr;
+        if (left and left->length > MIN_LENGTH)
+        {
+            insert_entry(*child, 0, left->keys[left->length - 1], std::move(payloads(*left)[left->length - 1]));
+            erase_entry(*left, left->length - 1);
+            parent.keys[i - 1] = left->get_pivot();
+            parent.keys[i] = child->get_pivot();
+        }
+        else if (right and right->length > MIN_LENGTH)
+        {
+            insert_entry(*child, child->length, right->keys[0], std::move(payloads(*right)[0]));
+            erase_entry(*right, 0);
+            parent.keys[i] = child->get_pivot();
+        }
+        else if (left)
+        {
+            move_entries(*child, 0, *left);
+            if constexpr (std::is_same_v<Node, Leaf>)
+                left->next = child->next;
+            delete child;
+            erase_entry(parent, i);
+            parent.keys[i - 1] = left->get_pivot();
+        }
+        else if (right)
+        {
+            move_entries(*right, 0, *child);
+            if constexpr (std::is_same_v<Node, Leaf>)
+                child->next = right->next;
+            delete right;
+            erase_entry(parent, i + 1);
+            parent.keys[i] = child->get_pivot();
+        }
+        else if (child->length != 0)
+        {
+            parent.keys[i] = child->get_pivot();
+        }
+        else
+        {
+            if constexpr (std::is_same_v<Node, Leaf>)
+            {
+                if (prev != nullptr)
+                    prev->next = child->next;
+            }
+            delete child;
+            erase_entry(parent, i);
+        }
+    }
+
+    /** Points the begin iterators to the leftmost leaf. */
+    void update_begin()
+    {
+        if (root == nullptr)
+        {
+            begin_iter = iterator();
+            const_begin_iter = const_iterator();
+            return;
+        }
+        Node *node = root;
+        for (size_type level = tree_height; level != 0; --level)
+            node = static_cast<INode *>(node)->node_ptrs[0];
+        begin_iter = iterator(static_cast<Leaf *>(node));
+        const_begin_iter = const_iterator(static_cast<Leaf *>(node));
+    }
+
+    std::pair<iterator, bool> insert_or_assign(const key_type &key, mapped_type &value, bool assign)
+    {
+        if (root == nullptr)
+        {
+            root = new Leaf();
+            tree_height = 0;
+        }
+
+        iterator pos;
+        bool inserted = true;
+        if (Node *sibling = insert_into(root, tree_height, key, value, assign, pos, inserted))
+        {
+            auto new_root = new INode(tree_height + 1);
+            insert_entry(*new_root, 0, pivot(root), root);
+            insert_entry(*new_root, 1, pivot(sibling), sibling);
+            root = new_root;
+            ++tree_height;
+        }
+        tree_size += inserted;
+        update_begin();
+        return {pos, inserted};
+    }
+
 public:
     ///> returns the size of the tree, i.e. the number of key-value pairs
     size_type size() const { return tree_size; }
     ///> returns the number if inner/non-leaf levels, a.k.a. the height
     size_type height() const { return tree_height; }
 
+    /** Inserts the pair of \p key and \p value behind all pairs with the same key and returns an `iterator` to it.
+     * Full nodes are split, such that nodes never exceed their size.  Invalidates all iterators. */
+    iterator insert(const key_type &key, mapped_type value) { return insert_or_assign(key, value, false).first; }
+
+    /** Assigns \p value to the first pair with \p key, if any, and inserts the pair of \p key and \p value otherwise.
+     * Returns an `iterator` to the pair and whether it was inserted.  Invalidates all iterators. */
+    std::pair<iterator, bool> insert_or_assign(const key_type &key, mapped_type value)
+    {
+        return insert_or_assign(key, value, true);
+    }
+
+    /** Erases all pairs with \p key and returns their number.  Nodes that fall below half of their capacity borrow
+     * from or are merged with a sibling.  Invalidates all iterators. */
+    size_type erase(const key_type &key)
+    {
+        size_type num_erased = 0;
+        while (root != nullptr and erase_from(root, tree_height, key, nullptr, 0))
+        {
+            ++num_erased;
+            /* Shrink the tree while the root has a single child, and drop an empty root. */
+            while (tree_height != 0 and static_cast<INode *>(root)->length <= 1)
+            {
+                auto old_root = static_cast<INode *>(root);
+                root = old_root->length ? old_root->node_ptrs[0] : nullptr;
+                delete old_root;
+                --tree_height;
+                if (root == nullptr)
+                    break;
+            }
+            if (root != nullptr and tree_height == 0 and static_cast<Leaf *>(root)->length == 0)
+            {
+                delete static_cast<Leaf *>(root);
+                root = nullptr;
+            }
+            if (root == nullptr)
+                tree_height = 0;
+        }
+        tree_size -= num_erased;
+        update_begin();
+        return num_erased;
+    }
+
     /** Returns an `iterator` to the smallest key-value pair of the tree, if any, and `end()` otherwise. */
     iterator begin() { return begin_iter; }
     /** Returns the past-the-end `iterator`. */
@@ -418,27 +718,19 @@ public:
     const_iterator find(const key_type &key) const
     {
         /* TODO 1.4.5 */
-        if (root == nullptr)
-            return end();
-
-        root->find(key);
-        if (find_iter.index == -1)
+        iterator it = lower_bound(key);
+        if (it == iterator() or not(it.current->keys[it.index] == key))
             return end();
-
-        return find_iter;
+        return it;
     }
     /** Returns an `iterator` to the first element with the given \p key, if any, and `end()` otherwise. */
     iterator find(const key_type &key)
     {
         /* TODO 1.4.5 */
-        if (root == nullptr)
-            return end();
-
-        root->find(key);
-        if (find_iter.index == -1)
+        iterator it = lower_bound(key);
+        if (it == iterator() or not(it.current->keys[it.index] == key))
             return end();
-
-        return find_iter;
+        return it;
     }
 
     /** Returns a `const_range` of all elements with key in the interval `[lo, hi)`, i.e. `lo` including and `hi`
@@ -446,59 +738,230 @@ public:
     const_range find_range(const key_type &lo, const key_type &hi) const
     {
         /* TODO 1.4.6 */
-        M_unreachable("not implemented");
+        if (not(lo < hi))
+            return const_range(end(), end());
+        return const_range(lower_bound(lo), lower_bound(hi));
     }
     /** Returns a `range` of all elements with key in the interval `[lo, hi)`, i.e. `lo` including and `hi` excluding.
      * */
     range find_range(const key_type &lo, const key_type &hi)
     {
         /* TODO 1.4.6 */
-        if (root == nullptr)
+        if (not(lo < hi))
             return range(end(), end());
-
-        root->lower_bound(lo);
-        auto lo_iter = lower_bound_iter;
-
-        if (lo_iter.index == -1)
-            return range(end(), end());
-
-        root->lower_bound(hi);
-        auto hi_iter = lower_bound_iter;
-        // while ((*hi_iter).first() < hi)
-        // {
-        //     ++hi_iter;
-        //     if (hi_iter == end())
-        //         break;
-        // }
-
-        if (hi_iter.index == -1)
-            hi_iter = end();
-
-        return range(lo_iter, hi_iter);
+        return range(lower_bound(lo), lower_bound(hi));
     }
 
     /** Returns a `const_range` of all elements with key equals to \p key. */
     const_range equal_range(const key_type &key) const
     {
         /* TODO 1.4.7 */
-        M_unreachable("not implemented");
+        return const_range(lower_bound(key), upper_bound(key));
     }
     /** Returns a `range` of all elements with key equals to \p key. */
     range equal_range(const key_type &key)
     {
         /* TODO 1.4.7 */
-        if (root == nullptr)
-            return range(end(), end());
+        return range(lower_bound(key), upper_bound(key));
+    }
 
-        root->lower_bound(key);
-        if (lower_bound_iter.index == -1)
-            return range(end(), end());
+    /** Looks up all \p keys, like `find()`, and writes the `const_iterator` for `keys[i]` to `out[i]`.  \p out must
+     * hold as many elements as \p keys.  See `FIND_BATCH_SIZE` for how the lookups are interleaved. */
+    void find_batch(std::span<const key_type> keys, std::span<const_iterator> out) const
+    {
+        M_insist(keys.size() == out.size(), "one iterator per key required");
+        find_batch_into(keys, out.data());
+    }
+    /** Looks up all \p keys, like `find()`, and writes the `iterator` for `keys[i]` to `out[i]`.  \p out must hold
+     * as many elements as \p keys.  See `FIND_BATCH_SIZE` for how the lookups are interleaved. */
+    void find_batch(std::span<const key_type> keys, std::span<iterator> out)
+    {
+        M_insist(keys.size() == out.size(), "one iterator per key required");
+        find_batch_into(keys, out.data());
+    }
+
+    ///> the number of lookups of `find_batch()` that descend the tree in lockstep, one level at a time
+    static constexpr size_type FIND_BATCH_SIZE = 128;
+
+private:
+    /** Implements `find_batch()`.  The keys are looked up in groups of `FIND_BATCH_SIZE`.  A group descends one level
+     * at a time: every lookup searches its node and prefetches the child it descends into, before any lookup touches a
+     * child.  The cache misses of a level hence overlap instead of stalling each lookup in turn. */
+    template <typename It>
+    void find_batch_into(std::span<const key_type> keys, It *out) const
+    {
+        const Node *nodes[FIND_BATCH_SIZE];
+        for (size_type begin = 0; begin < keys.size(); begin += FIND_BATCH_SIZE)
+        {
+            const size_type n = std::min(FIND_BATCH_SIZE, keys.size() - begin);
+            const key_type *group = keys.data() + begin;
+            std::fill_n(nodes, n, root);
+
+            for (size_type level = tree_height; level != 0; --level)
+            {
+                for (size_type i = 0; i != n; ++i)
+                {
+                    if (nodes[i] == nullptr)
+                        continue;
+                    auto inode = static_cast<const INode *>(nodes[i]);
+                    const size_type pos = node_bound<false>(inode->keys.data(), inode->length, group[i]);
+                    nodes[i] = pos == inode->length ? nullptr : inode->node_ptrs[pos];
+                    prefetch(nodes[i], level - 1);
+                }
+            }
 
-        root->upper_bound(key);
+            for (size_type i = 0; i != n; ++i)
+            {
+                out[begin + i] = end_iter;
+                if (nodes[i] == nullptr)
+                    continue;
+                auto leaf = const_cast<Leaf *>(static_cast<const Leaf *>(nodes[i]));
+                const size_type pos = node_bound<false>(leaf->keys.data(), leaf->length, group[i]);
+                if (pos != leaf->length and leaf->keys[pos] == group[i])
+                    out[begin + i] = iterator(leaf, pos);
+            }
+        }
+    }
+
+    /** Prefetches the header of \p node at \p level, if any, and the middle of its keys, where its search begins. */
+    static void prefetch(const Node *node, size_type level)
+    {
+        if (node == nullptr)
+            return;
+        __builtin_prefetch(node);
+        if (level == 0)
+            __builtin_prefetch(&static_cast<const Leaf *>(node)->keys[NUM_KEYS_PER_LEAF / 2]);
+        else
+            __builtin_prefetch(&static_cast<const INode *>(node)->keys[NUM_KEYS_PER_INODE / 2]);
+    }
 
-        if (upper_bound_iter.index == -1)
-            return range(lower_bound_iter, end());
+    /** Returns an `iterator` to the first element with key not less than \p key, if any, and `end()` otherwise. */
+    iterator lower_bound(const key_type &key) const { return search<false>(key); }
+    /** Returns an `iterator` to the first element with key greater than \p key, if any, and `end()` otherwise. */
+    iterator upper_bound(const key_type &key) const { return search<true>(key); }
+
+    ///> the number of keys, four cache lines, below which a node search switches from binary search to SIMD compares
+    static constexpr size_type SIMD_WINDOW_SIZE = 256 / sizeof(key_type);
+
+    /** Returns the position of the first of the \p n sorted \p keys that is not less than (or, if \tparam Upper,
+     * greater than) \p key, or \p n if there is none.  Integral keys of 4 or 8 bytes are searched with AVX-512 or
+     * AVX2, if available: a binary search narrows the keys down to `SIMD_WINDOW_SIZE` keys, within which the position
+     * is the number of keys in front of the bound, counted with vector compares and masks. */
+    template <bool Upper>
+    static size_type node_bound(const key_type *keys, size_type n, const key_type &key)
+    {
+#if defined(__AVX512F__) || defined(__AVX2__)
+        if constexpr (std::is_integral_v<key_type> and (sizeof(key_type) == 4 or sizeof(key_type) == 8))
+        {
+            size_type first = 0;
+            while (n > SIMD_WINDOW_SIZE)
+            {
+                const size_type half = n / 2;
+                if (Upper ? not(key < keys[first + half]) : keys[first + half] < key)
+                {
+                    first += half + 1;
+                    n -= half + 1;
+                }
+                else
+                {
+                    n = half;
+                }
+            }
+            return first + count_in_front<Upper>(keys + first, n, key);
+        }
+#endif
+        if constexpr (Upper)
+            return std::upper_bound(keys, keys + n, key) - keys;
+        else
+            return std::lower_bound(keys, keys + n, key) - keys;
+    }
+
+#if defined(__AVX512F__) || defined(__AVX2__)
+    /** Returns the number of the \p n sorted \p keys that are less than (or, if \tparam Upper, not greater than)
+     * \p key.  Unsigned keys are compared as signed ones with their sign bit flipped. */
+    template <bool Upper>
+    static size_type count_in_front(const key_type *keys, size_type n, const key_type &key)
+    {
+        using lane_type = std::conditional_t<sizeof(key_type) == 4, int32_t, int64_t>;
+        constexpr lane_type BIAS = std::is_signed_v<key_type> ? 0 : std::numeric_limits<lane_type>::min();
+        const lane_type needle = lane_type(key) ^ BIAS;
+        size_type count = 0;
+#if defined(__AVX512F__)
+        /* The last vector is loaded and compared masked, such that keys behind the `n`-th are never read. */
+        constexpr size_type LANES = 64 / sizeof(key_type);
+        for (size_type i = 0; i < n; i += LANES)
+        {
+            const uint32_t valid = n - i >= LANES ? (1U << LANES) - 1 : (1U << (n - i)) - 1;
+            if constexpr (sizeof(key_type) == 4)
+            {
+                const __m512i v = _mm512_xor_si512(_mm512_maskz_loadu_epi32(valid, keys + i), _mm512_set1_epi32(BIAS));
+                const __m512i k = _mm512_set1_epi32(needle);
+                count += std::popcount(unsigned(Upper ? _mm512_mask_cmple_epi32_mask(valid, v, k)
+                                                      : _mm512_mask_cmplt_epi32_mask(valid, v, k)));
+            }
+            else
+            {
+                const __m512i v = _mm512_xor_si512(_mm512_maskz_loadu_epi64(valid, keys + i), _mm512_set1_epi64(BIAS));
+                const __m512i k = _mm512_set1_epi64(needle);
+                count += std::popcount(unsigned(Upper ? _mm512_mask_cmple_epi64_mask(valid, v, k)
+                                                      : _mm512_mask_cmplt_epi64_mask(valid, v, k)));
+            }
+        }
+#else
+        constexpr size_type LANES = 32 / sizeof(key_type);
+        size_type i = 0;
+        for (; i + LANES <= n; i += LANES)
+        {
+            const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(keys + i));
+            unsigned mask;
+            if constexpr (sizeof(key_type) == 4)
+            {
+                const __m256i x = _mm256_xor_si256(v, _mm256_set1_epi32(BIAS));
+                const __m256i k = _mm256_set1_epi32(needle);
+                mask = _mm256_movemask_ps(_mm256_castsi256_ps(Upper ? _mm256_cmpgt_epi32(x, k)
+                                                                    : _mm256_cmpgt_epi32(k, x)));
+            }
+            else
+            {
+                const __m256i x = _mm256_xor_si256(v, _mm256_set1_epi64x(BIAS));
+                const __m256i k = _mm256_set1_epi64x(needle);
+                mask = _mm256_movemask_pd(_mm256_castsi256_pd(Upper ? _mm256_cmpgt_epi64(x, k)
+                                                                    : _mm256_cmpgt_epi64(k, x)));
+            }
+            /* With `Upper`, the mask holds the keys greater than `key`. */
+            count += Upper ? LANES - std::popcount(mask) : std::popcount(mask);
+        }
+        for (; i != n; ++i)
+            count += Upper ? not(key < keys[i]) : keys[i] < key;
+#endif
+        return count;
+    }
+#endif
+
+    /** Descends from the root to the leaf holding the first element with key not less than (or, if \tparam Upper,
+     * greater than) \p key and returns an `iterator` to it, or `end()` if there is none.  Every inner node stores the
+     * greatest key of each child, hence the leaf is found without backtracking.  The descent only reads the tree and
+     * keeps its state on the stack, such that any number of threads may search concurrently. */
+    template <bool Upper>
+    iterator search(const key_type &key) const
+    {
+        if (root == nullptr)
+            return iterator();
+
+        Node *node = root;
+        for (size_type level = tree_height; level != 0; --level)
+        {
+            auto inode = static_cast<INode *>(node);
+            const size_type i = node_bound<Upper>(inode->keys.data(), inode->length, key);
+            if (i == inode->length)
+                return iterator();
+            node = inode->node_ptrs[i];
+        }
 
-        return range(lower_bound_iter, upper_bound_iter);
+        auto leaf = static_cast<Leaf *>(node);
+        const size_type i = node_bound<Upper>(leaf->keys.data(), leaf->length, key);
+        if (i == leaf->length)
+            return iterator(); // only if the leaf is the root
+        return iterator(leaf, i);
     }
 };
@@ -0,0 +1,179 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <concepts>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+
+/** A column of integers of type \tparam T compressed with frame-of-reference (FOR) encoding, organized in blocks of
+ * \tparam TuplesPerBlock values, like the minipage of an attribute in a PAX block.  Every block stores its minimum as
+ * base and every value as the delta to that base, bit-packed with as few bits as the largest delta of the block needs.
+ * Dense or slowly changing values, e.g. monotonically increasing keys, hence need only a few bits per value.  The
+ * minimum and maximum of every block are retained.
+ *
+ * Values are appended to an unencoded tail block, which is encoded as soon as it is full. */
+template<std::integral T, std::size_t TuplesPerBlock = 1024>
+struct FORColumn
+{
+    using value_type = T;
+    using size_type = std::size_t;
+
+    static constexpr size_type TUPLES_PER_BLOCK = TuplesPerBlock;
+
+    /** The header of an encoded block. */
+    struct block_header
+    {
+        value_type min; ///< the minimum, which is also the base of the deltas
+        value_type max; ///< the maximum
+        uint8_t bit_width; ///< the number of bits per delta
+        size_type offset; ///< the offset of the first word of the packed deltas
+    };
+
+    private:
+    using unsigned_type = std::make_unsigned_t<value_type>;
+
+    std::vector<block_header> blocks_; ///< headers of the encoded blocks
+    std::vector<uint64_t> words_; ///< bit-packed deltas of all encoded blocks
+    std::vector<value_type> tail_; ///< values not yet encoded
+    size_type size_ = 0;
+
+    public:
+    FORColumn() { tail_.reserve(TUPLES_PER_BLOCK); }
+
+    /** Encodes the values in the range from \p begin to \p end. */
+    template<typename It>
+    static FORColumn Encode(It begin, It end)
+    {
+        FORColumn column;
+        for (; begin != end; ++begin)
+            column.append(*begin);
+        return column;
+    }
+
+    ///> returns the number of values
+    size_type size() const { return size_; }
+    ///> returns the number of blocks, including the tail block if it is not empty
+    size_type num_blocks() const { return blocks_.size() + not tail_.empty(); }
+    ///> returns the number of bytes occupied by block headers and packed deltas, and the unencoded tail
+    size_type size_in_bytes() const {
+        return blocks_.size() * sizeof(block_header) + words_.size() * sizeof(uint64_t) +
+               tail_.size() * sizeof(value_type);
+    }
+
+    /** Returns the minimum of the values in block \p b. */
+    value_type min(size_type b) const {
+        return b < blocks_.size() ? blocks_[b].min : *std::min_element(tail_.begin(), tail_.end());
+    }
+    /** Returns the maximum of the values in block \p b. */
+    value_type max(size_type b) const {
+        return b < blocks_.size() ? blocks_[b].max : *std::max_element(tail_.begin(), tail_.end());
+    }
+    /** Returns the number of values in block \p b. */
+    size_type block_size(size_type b) const { return b < blocks_.size() ? TUPLES_PER_BLOCK : tail_.size(); }
+
+    /** Appends \p value to the column. */
+    void append(value_type value)
+    {
+        tail_.push_back(value);
+        ++size_;
+        if (tail_.size() == TUPLES_PER_BLOCK)
+            seal();
+    }
+
+    /** Returns the value at position \p idx. */
+    value_type operator[](size_type idx) const
+    {
+        assert(idx < size_);
+        const size_type b = idx / TUPLES_PER_BLOCK;
+        if (b == blocks_.size())
+            return tail_[idx % TUPLES_PER_BLOCK];
+        const auto &block = blocks_[b];
+        return value_type(unsigned_type(block.min) + unpack(block, idx % TUPLES_PER_BLOCK));
+    }
+
+    /** Decodes all values of block \p b to \p out and returns the number of values decoded. */
+    size_type decode_block(size_type b, value_type *out) const
+    {
+        if (b == blocks_.size()) {
+            std::copy(tail_.begin(), tail_.end(), out);
+            return tail_.size();
+        }
+
+        const auto &block = blocks_[b];
+        const unsigned_type base = block.min;
+        const uint64_t *words = words_.data() + block.offset;
+        const unsigned width = block.bit_width;
+        if (width == 0) {
+            std::fill_n(out, TUPLES_PER_BLOCK, block.min);
+            return TUPLES_PER_BLOCK;
+        }
+
+        const uint64_t mask = width == 64 ? ~uint64_t(0) : (uint64_t(1) << width) - 1;
+        uint64_t bit = 0;
+        for (size_type i = 0; i != TUPLES_PER_BLOCK; ++i, bit += width) {
+            const uint64_t word = bit / 64, shift = bit % 64;
+            uint64_t delta = words[word] >> shift;
+            if (shift + width > 64)
+                delta |= words[word + 1] << (64 - shift);
+            out[i] = value_type(base + unsigned_type(delta & mask));
+        }
+        return TUPLES_PER_BLOCK;
+    }
+
+    /** Decodes all values to \p out, which must provide space for `size()` values. */
+    void decode(value_type *out) const
+    {
+        for (size_type b = 0; b != num_blocks(); ++b)
+            out += decode_block(b, out);
+    }
+
+    private:
+    /** Encodes the full tail block. */
+    void seal()
+    {
+        auto [min, max] = std::minmax_element(tail_.begin(), tail_.end());
+        block_header block{ *min, *max, 0, words_.size() };
+        block.bit_width = std::bit_width(delta(*max, *min));
+
+        const unsigned width = block.bit_width;
+        words_.resize(words_.size() + (TUPLES_PER_BLOCK * width + 63) / 64);
+        uint64_t *words = words_.data() + block.offset;
+        uint64_t bit = 0;
+        for (auto value : tail_) {
+            if (width == 0)
+                break;
+            const uint64_t d = delta(value, block.min);
+            const uint64_t word = bit / 64, shift = bit % 64;
+            words[word] |= d << shift;
+            if (shift + width > 64)
+                words[word + 1] |= d >> (64 - shift);
+            bit += width;
+        }
+
+        blocks_.push_back(block);
+        tail_.clear();
+    }
+
+    /** Returns the difference of \p value and \p base as unsigned integer, without overflow. */
+    static uint64_t delta(value_type value, value_type base) {
+        return unsigned_type(unsigned_type(value) - unsigned_type(base));
+    }
+
+    /** Returns the delta of the value at position \p i within \p block. */
+    uint64_t unpack(const block_header &block, size_type i) const
+    {
+        const unsigned width = block.bit_width;
+        if (width == 0)
+            return 0;
+        const uint64_t bit = i * width, word = block.offset + bit / 64, shift = bit % 64;
+        uint64_t delta = words_[word] >> shift;
+        if (shift + width > 64)
+            delta |= words_[word + 1] << (64 - shift);
+        return width == 64 ? delta : delta & ((uint64_t(1) << width) - 1);
+    }
+};
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+
+
+/** A column of variable-length strings, organized in blocks of \tparam TuplesPerBlock strings, like the minipage of an
+ * attribute in a PAX block.  Every string has a fixed-size slot of 16 bytes holding its length, its first four bytes
+ * (the *prefix*), and either its remaining bytes, if the string is at most `INLINE_LENGTH` bytes long, or the offset of
+ * its remaining bytes in the string heap of the block.  Hence, a string occupies its slot plus its actual length beyond
+ * the prefix, rather than its maximal length like `CHAR(n)`, and most comparisons are decided by length and prefix,
+ * without touching the heap. */
+template<std::size_t TuplesPerBlock = 1024>
+struct StringColumn
+{
+    using size_type = std::size_t;
+
+    static constexpr size_type TUPLES_PER_BLOCK = TuplesPerBlock;
+    static constexpr size_type PREFIX_LENGTH = 4;
+    ///> the maximal length of strings stored entirely in their slot
+    static constexpr size_type INLINE_LENGTH = 12;
+
+    /** The slot of a string. */
+    struct slot
+    {
+        uint32_t length;
+        char prefix[PREFIX_LENGTH];
+        union {
+            char suffix[INLINE_LENGTH - PREFIX_LENGTH]; ///< the remaining bytes of an inlined string
+            uint64_t offset; ///< the offset of the remaining bytes in the heap of the block
+        };
+    };
+    static_assert(sizeof(slot) == 16);
+
+    private:
+    std::vector<slot> slots_;
+    std::vector<std::string> heaps_; ///< one heap per block
+
+    public:
+    ///> returns the number of strings
+    size_type size() const { return slots_.size(); }
+    ///> returns the number of blocks
+    size_type num_blocks() const { return heaps_.size(); }
+    ///> returns the number of bytes occupied by slots and heaps
+    size_type size_in_bytes() const {
+        size_type size = slots_.size() * sizeof(slot);
+        for (auto &heap : heaps_)
+            size += heap.size();
+        return size;
+    }
+
+    /** Appends \p str to the column. */
+    void append(std::string_view str)
+    {
+        if (slots_.size() % TUPLES_PER_BLOCK == 0)
+            heaps_.emplace_back();
+
+        slot s;
+        std::memset(&s, 0, sizeof(s));
+        s.length = str.size();
+        std::memcpy(s.prefix, str.data(), std::min(str.size(), PREFIX_LENGTH));
+        if (str.size() <= INLINE_LENGTH) {
+            if (str.size() > PREFIX_LENGTH)
+                std::memcpy(s.suffix, str.data() + PREFIX_LENGTH, str.size() - PREFIX_LENGTH);
+        } else {
+            auto &heap = heaps_.back();
+            s.offset = heap.size();
+            heap.append(str.substr(PREFIX_LENGTH));
+        }
+        slots_.push_back(s);
+    }
+
+    /** Returns the string at position \p idx. */
+    std::string get(size_type idx) const
+    {
+        assert(idx < size());
+        const slot &s = slots_[idx];
+        std::string str(s.prefix, std::min<size_type>(s.length, PREFIX_LENGTH));
+        str.append(suffix(idx));
+        return str;
+    }
+
+    /** Returns `true` iff the string at position \p idx equals \p str. */
+    bool equals(size_type idx, std::string_view str) const
+    {
+        assert(idx < size());
+        const slot &s = slots_[idx];
+        if (s.length != str.size())
+            return false;
+        if (std::memcmp(s.prefix, str.data(), std::min(str.size(), PREFIX_LENGTH)) != 0)
+            return false;
+        return str.size() <= PREFIX_LENGTH or suffix(idx) == str.substr(PREFIX_LENGTH);
+    }
+
+    /** Returns `true` iff the string at position \p idx starts with \p prefix, i.e. matches `LIKE 'prefix%'`. */
+    bool starts_with(size_type idx, std::string_view prefix) const
+    {
+        assert(idx < size());
+        const slot &s = slots_[idx];
+        if (s.length < prefix.size())
+            return false;
+        if (std::memcmp(s.prefix, prefix.data(), std::min(prefix.size(), PREFIX_LENGTH)) != 0)
+            return false;
+        return prefix.size() <= PREFIX_LENGTH or suffix(idx).starts_with(prefix.substr(PREFIX_LENGTH));
+    }
+
+    private:
+    /** Returns the bytes of the string at position \p idx beyond its prefix. */
+    std::string_view suffix(size_type idx) const
+    {
+        const slot &s = slots_[idx];
+        if (s.length <= PREFIX_LENGTH)
+            return std::string_view();
+        if (s.length <= INLINE_LENGTH)
+            return std::string_view(s.suffix, s.length - PREFIX_LENGTH);
+        return std::string_view(heaps_[idx / TUPLES_PER_BLOCK]).substr(s.offset, s.length - PREFIX_LENGTH);
+    }
+};
@@ -0,0 +1,131 @@
+#include "column_writer.hpp"
+#include "data_layouts.hpp"
+#include <algorithm>
+#include <cstring>
+#include <optional>
+#include <stdexcept>
+
+
+using namespace m;
+using namespace m::storage;
+
+
+namespace {
+
+/** Writes the low \p n bits of \p value to the \p n bits starting at bit \p offset of \p memory. */
+void write_bits(uint8_t *memory, uint64_t offset, uint64_t value, std::size_t n)
+{
+    while (n) {
+        uint8_t &byte = memory[offset / 8];
+        const unsigned shift = offset % 8;
+        const std::size_t k = std::min<std::size_t>(n, 8 - shift);
+        const uint8_t mask = ((1U << k) - 1) << shift;
+        byte = (byte & ~mask) | ((value << shift) & mask);
+        value >>= k;
+        offset += k;
+        n -= k;
+    }
+}
+
+bool is_null(const column_batch &column, std::size_t i)
+{
+    return column.nulls and (column.nulls[i / 8] >> (i % 8)) & 1;
+}
+
+/** Copies \p n values of \tparam Size bytes from \p src to \p dst, \p stride bytes apart. */
+template<std::size_t Size>
+void scatter(uint8_t *dst, std::size_t stride, const uint8_t *src, std::size_t n)
+{
+    for (std::size_t i = 0; i != n; ++i)
+        std::memcpy(dst + i * stride, src + i * Size, Size);
+}
+
+/** Copies \p n values of \p size bytes from \p src to \p dst, \p stride bytes apart. */
+void scatter(uint8_t *dst, std::size_t stride, const uint8_t *src, std::size_t size, std::size_t n)
+{
+    if (stride == size) {
+        std::memcpy(dst, src, n * size);
+        return;
+    }
+    switch (size) {
+        case 1: scatter<1>(dst, stride, src, n); break;
+        case 2: scatter<2>(dst, stride, src, n); break;
+        case 4: scatter<4>(dst, stride, src, n); break;
+        case 8: scatter<8>(dst, stride, src, n); break;
+        default:
+            for (std::size_t i = 0; i != n; ++i)
+                std::memcpy(dst + i * stride, src + i * size, size);
+    }
+}
+
+}
+
+void write_columns(const Schema &schema, const DataLayout &layout, void *memory, std::size_t first_row,
+                   std::size_t num_rows, const std::vector<column_batch> &columns)
+{
+    const std::size_t num_attrs = schema.num_entries();
+    if (columns.size() != num_attrs)
+        throw std::invalid_argument("expected " + std::to_string(num_attrs) + " columns, got " +
+                                    std::to_string(columns.size()));
+    std::optional<attribute_path> bitmap_path;
+    try {
+        bitmap_path = compute_attribute_path(layout, num_attrs);
+    } catch (const std::out_of_range&) {
+        /* the layout stores no NULL bitmap */
+    }
+    const bool has_nulls = std::any_of(columns.begin(), columns.end(), [](auto &c) { return c.nulls != nullptr; });
+    if (has_nulls and not bitmap_path)
+        throw std::invalid_argument("NULL values in a layout without NULL bitmap");
+
+    /* Write the values attribute by attribute, in runs of equally strided tuples. */
+    auto bytes = static_cast<uint8_t*>(memory);
+    for (std::size_t attr = 0; attr != num_attrs; ++attr) {
+        const auto path = compute_attribute_path(layout, attr);
+        const uint64_t stride_in_bits = path.tuple_stride_in_bits();
+        const Type *type = schema[attr].type;
+
+        if (type->is_boolean()) {
+            auto values = static_cast<const bool*>(columns[attr].values);
+            for (std::size_t i = 0; i != num_rows; ++i)
+                write_bits(bytes, path.offset_in_bits(first_row + i), values[i], 1);
+            continue;
+        }
+
+        M_insist(type->size() % 8 == 0 and stride_in_bits % 8 == 0, "values other than Booleans must be byte-aligned");
+        const std::size_t size = type->size() / 8;
+        auto values = static_cast<const uint8_t*>(columns[attr].values);
+        for (std::size_t i = 0; i != num_rows;) {
+            const uint64_t offset = path.offset_in_bits(first_row + i);
+            M_insist(offset % 8 == 0, "values other than Booleans must be byte-aligned");
+            const std::size_t n = std::min(num_rows - i, path.num_strided_rows(first_row + i));
+            scatter(bytes + offset / 8, stride_in_bits / 8, values + i * size, size, n);
+            i += n;
+        }
+    }
+
+    /* Write the NULL bitmap of every tuple, 64 attributes at a time. */
+    if (not bitmap_path)
+        return;
+    for (std::size_t i = 0; i != num_rows; ++i) {
+        const uint64_t offset = bitmap_path->offset_in_bits(first_row + i);
+        for (std::size_t attr = 0; attr < num_attrs; attr += 64) {
+            const std::size_t n = std::min<std::size_t>(num_attrs - attr, 64);
+            uint64_t mask = 0;
+            if (has_nulls) {
+                for (std::size_t j = 0; j != n; ++j)
+                    mask |= uint64_t(is_null(columns[attr + j], i)) << j;
+            }
+            write_bits(bytes, offset + attr, mask, n);
+        }
+    }
+}
+
+std::size_t append_columns(Table &table, std::size_t num_rows, const std::vector<column_batch> &columns)
+{
+    auto &store = table.store();
+    const std::size_t first_row = store.num_rows();
+    for (std::size_t i = 0; i != num_rows; ++i)
+        store.append();
+    write_columns(table.schema(), table.layout(), store.memory().addr(), first_row, num_rows, columns);
+    return first_row;
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <mutable/mutable.hpp>
+#include <vector>
+
+
+/** The values of one attribute for a batch of consecutive tuples. */
+struct column_batch
+{
+    /** The values, densely packed in an array with one element of the attribute's size per tuple, i.e. `int32_t` for
+     * `INT(4)` or `char[n]` for `CHAR(n)`.  Booleans are passed as `bool`s. */
+    const void *values;
+    /** Optionally, the NULL mask, LSB-first with bit `i` set iff the value of tuple `i` is NULL.  If `nullptr`, no value
+     * is NULL. */
+    const uint8_t *nulls = nullptr;
+};
+
+/** Writes the \p num_rows tuples given column-wise by \p columns, one batch per attribute of \p schema, to the tuples
+ * \p first_row, \p first_row + 1, ... stored in \p layout at \p memory.  The memory of these tuples must already be
+ * allocated.  The values of an attribute are written in runs of tuples up to the end of a block of \p layout: runs
+ * of densely packed values, e.g. of PAX minipages or columns, are copied with a single `memcpy()`, and runs of values
+ * with a larger stride, e.g. of rows, are scattered with a loop specialized for the size of the attribute.  Throws
+ * `std::invalid_argument` if the number of batches does not match \p schema, or if a batch with NULL values is given
+ * for a layout without NULL bitmap. */
+void write_columns(const m::Schema &schema, const m::storage::DataLayout &layout, void *memory, std::size_t first_row,
+                   std::size_t num_rows, const std::vector<column_batch> &columns);
+
+/** Appends the \p num_rows tuples given column-wise by \p columns to \p table, like appending them one at a time with
+ * a `m::StoreWriter` does.  Returns the index of the first appended tuple. */
+std::size_t append_columns(m::Table &table, std::size_t num_rows, const std::vector<column_batch> &columns);
@@ -0,0 +1,61 @@
+#include "csv.hpp"
+
+
+bool read_CSV_record(std::istream &in, std::vector<std::string> &fields, char delimiter, char quote, char escape)
+{
+    fields.clear();
+    if (in.peek() == std::char_traits<char>::eof())
+        return false;
+
+    std::string field;
+    bool quoted = false;
+    for (int c; (c = in.get()) != std::char_traits<char>::eof(); ) {
+        if (quoted) {
+            if (c == escape and escape != quote) {
+                if ((c = in.get()) == std::char_traits<char>::eof())
+                    break;
+                field += char(c); // escaped character
+            } else if (c == quote) {
+                if (in.peek() == quote)
+                    field += char(in.get()); // escaped quote
+                else
+                    quoted = false;
+            } else {
+                field += char(c);
+            }
+        } else if (c == quote) {
+            quoted = true;
+        } else if (c == delimiter) {
+            fields.push_back(std::move(field));
+            field.clear();
+        } else if (c == '\n') {
+            break;
+        } else if (c != '\r') {
+            field += char(c);
+        }
+    }
+    fields.push_back(std::move(field));
+    return true;
+}
+
+void write_CSV_record(std::ostream &out, const std::vector<std::string> &fields, char delimiter, char quote,
+                      char escape)
+{
+    const char special[] = { delimiter, quote, '\n', '\r', escape, 0 };
+    for (std::size_t i = 0; i != fields.size(); ++i) {
+        if (i)
+            out << delimiter;
+        if (fields[i].find_first_of(special) == std::string::npos) {
+            out << fields[i];
+            continue;
+        }
+        out << quote;
+        for (char c : fields[i]) {
+            if (c == quote or c == escape)
+                out << escape;
+            out << c;
+        }
+        out << quote;
+    }
+    out << '\n';
+}
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
+
+
+/** Reads the next record of a CSV file from \p in into \p fields.  Fields may be enclosed in \p quote, in which case
+ * they may contain delimiters, newlines, and quotes, which are either doubled or preceded by \p escape.  Within quoted
+ * fields, \p escape makes the next character literal, like in `m::load_from_CSV()`.  An \p escape equal to \p quote
+ * disables escaping.  Returns `false` if there is no more record. */
+bool read_CSV_record(std::istream &in, std::vector<std::string> &fields, char delimiter = ',', char quote = '"',
+                     char escape = '\\');
+
+/** Writes \p fields as a CSV record to \p out.  Fields containing the delimiter, quotes, escape characters, or newlines
+ * are quoted, with quotes and escape characters preceded by \p escape, such that `m::load_from_CSV()` reads them back.
+ * If \p escape equals \p quote, quotes are doubled instead. */
+void write_CSV_record(std::ostream &out, const std::vector<std::string> &fields, char delimiter = ',', char quote = '"',
+                      char escape = '\\');
@@ -0,0 +1,400 @@
+#include "csv_loader.hpp"
+#include "csv_tokenizer.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <exception>
+#include <fcntl.h>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+
+
+using namespace m;
+using namespace m::storage;
+
+
+namespace {
+
+/** Calls \p fn with every index in [0, \p n), each in its own thread.  Rethrows the first exception thrown by any call
+ * after all threads finished. */
+template<typename Fn>
+void run_in_parallel(std::size_t n, Fn &&fn)
+{
+    std::vector<std::exception_ptr> errors(n);
+    {
+        std::vector<std::jthread> threads;
+        for (std::size_t i = 0; i != n; ++i) {
+            threads.emplace_back([&fn, &errors, i]() {
+                try {
+                    fn(i);
+                } catch (...) {
+                    errors[i] = std::current_exception();
+                }
+            });
+        }
+    }
+    for (auto &error : errors) {
+        if (error)
+            std::rethrow_exception(error);
+    }
+}
+
+/** Returns whether the character at \p p is escaped, i.e. preceded by an odd number of \p escape characters, where
+ * \p begin is the beginning of the data.  An \p escape equal to \p quote disables escaping. */
+bool is_escaped(const char *begin, const char *p, char quote, char escape)
+{
+    if (escape == quote)
+        return false;
+    const char *q = p;
+    while (q != begin and q[-1] == escape)
+        --q;
+    return (p - q) % 2;
+}
+
+/** Returns the end of the record starting at \p p, i.e. the position behind its terminating newline, or \p end.  The
+ * record starts inside a quoted field if \p quoted.  Quotes and escape characters preceded by \p escape do not count.
+ * \p p must not be an escaped character. */
+const char * find_record_end(const char *p, const char *end, char quote, char escape, bool quoted = false)
+{
+    for (; p != end; ++p) {
+        if (*p == escape and escape != quote and p + 1 != end and (p[1] == quote or p[1] == escape))
+            ++p; // escaped quote or escape character
+        else if (*p == quote)
+            quoted = not quoted;
+        else if (*p == '\n' and not quoted)
+            return p + 1;
+    }
+    return end;
+}
+
+/** A read-only memory mapping of a whole file. */
+struct mapped_file
+{
+    const char *data = nullptr;
+    std::size_t size = 0;
+
+    explicit mapped_file(const std::filesystem::path &path)
+    {
+        const int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+            throw std::runtime_error("could not open " + path.string() + ": " + std::strerror(errno));
+        struct stat st;
+        if (fstat(fd, &st) != 0) {
+            close(fd);
+            throw std::runtime_error("could not stat " + path.string() + ": " + std::strerror(errno));
+        }
+        size = st.st_size;
+        if (size) {
+            void *addr = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (addr == MAP_FAILED) {
+                close(fd);
+                throw std::runtime_error("could not map " + path.string() + ": " + std::strerror(errno));
+            }
+            madvise(addr, size, MADV_SEQUENTIAL);
+            data = static_cast<const char*>(addr);
+        }
+        close(fd);
+    }
+
+    mapped_file(const mapped_file&) = delete;
+    ~mapped_file() {
+        if (data)
+            munmap(const_cast<char*>(data), size);
+    }
+};
+
+/** Sets bit \p bit of \p memory to \p value.  Bits of neighbouring tuples may share a byte and be written by other
+ * threads concurrently, hence the byte is updated atomically. */
+void write_bit(uint8_t *memory, uint64_t bit, bool value)
+{
+    std::atomic_ref<uint8_t> byte(memory[bit / 8]);
+    if (value)
+        byte.fetch_or(uint8_t(1) << (bit % 8), std::memory_order_relaxed);
+    else
+        byte.fetch_and(~(uint8_t(1) << (bit % 8)), std::memory_order_relaxed);
+}
+
+/** Parses \p field as number of type \tparam T.  Throws `std::invalid_argument` if \p field is not a number. */
+template<typename T>
+T parse_number(std::string_view field)
+{
+    T value;
+    auto [ptr, ec] = std::from_chars(field.data(), field.data() + field.size(), value);
+    if (ec != std::errc() or ptr != field.data() + field.size())
+        throw std::invalid_argument("invalid number '" + std::string(field) + "'");
+    return value;
+}
+
+/** Writes the low \p size_in_bits of \p value to \p p. */
+void write_integer(uint8_t *p, int64_t value, uint64_t size_in_bits)
+{
+    switch (size_in_bits) {
+        case 8:  { int8_t v = value;  std::memcpy(p, &v, sizeof(v)); break; }
+        case 16: { int16_t v = value; std::memcpy(p, &v, sizeof(v)); break; }
+        case 32: { int32_t v = value; std::memcpy(p, &v, sizeof(v)); break; }
+        case 64: { std::memcpy(p, &value, sizeof(value)); break; }
+        default: throw std::invalid_argument("unsupported integer size");
+    }
+}
+
+/** Writes the value of \p field, which is of type \p type, at bit \p offset of \p memory. */
+void write_value(uint8_t *memory, uint64_t offset, const Type *type, std::string_view field)
+{
+    if (type->is_boolean()) {
+        if (field == "TRUE" or field == "true" or field == "1")
+            write_bit(memory, offset, true);
+        else if (field == "FALSE" or field == "false" or field == "0")
+            write_bit(memory, offset, false);
+        else
+            throw std::invalid_argument("invalid Boolean '" + std::string(field) + "'");
+        return;
+    }
+
+    M_insist(offset % 8 == 0, "values other than Booleans must be byte-aligned");
+    uint8_t *p = memory + offset / 8;
+    if (type->is_character_sequence()) {
+        /* Truncate to the length of the attribute and pad with NUL bytes. */
+        const std::size_t length = type->size() / 8;
+        const std::size_t n = std::min(length, field.size());
+        std::memcpy(p, field.data(), n);
+        std::memset(p + n, 0, length - n);
+    } else if (type->is_float()) {
+        const float value = parse_number<float>(field);
+        std::memcpy(p, &value, sizeof(value));
+    } else if (type->is_double()) {
+        const double value = parse_number<double>(field);
+        std::memcpy(p, &value, sizeof(value));
+    } else if (type->is_numeric() and as<const Numeric>(type)->kind == Numeric::N_Decimal) {
+        const double value = parse_number<double>(field) * std::pow(10., as<const Numeric>(type)->scale);
+        write_integer(p, std::llround(value), type->size());
+    } else if (type->is_integral()) {
+        write_integer(p, parse_number<int64_t>(field), type->size());
+    } else {
+        throw std::invalid_argument("unsupported attribute type");
+    }
+}
+
+}
+
+std::vector<CSV_chunk> split_CSV(const char *begin, const char *end, std::size_t num_chunks, char quote, char escape)
+{
+    const std::size_t size = end - begin;
+    if (size == 0)
+        return {};
+    num_chunks = std::clamp<std::size_t>(num_chunks, 1, size);
+
+    /* Count the unescaped quotes between every two candidate boundaries in parallel. */
+    auto candidate = [=](std::size_t k) { return begin + k * size / num_chunks; };
+    std::vector<std::size_t> num_quotes(num_chunks);
+    run_in_parallel(num_chunks, [&](std::size_t k) {
+        const char *last = candidate(k + 1);
+        std::size_t n = 0;
+        for (const char *p = std::find(candidate(k), last, quote); p != last; p = std::find(p + 1, last, quote))
+            n += not is_escaped(begin, p, quote, escape);
+        num_quotes[k] = n;
+    });
+
+    /* A candidate is inside a quoted field iff an odd number of quotes precedes it.  Move every candidate to the end of
+     * the record it falls into. */
+    std::vector<const char*> boundaries(num_chunks + 1, end);
+    boundaries[0] = begin;
+    std::vector<bool> quoted(num_chunks);
+    for (std::size_t k = 1, preceding = num_quotes[0]; k != num_chunks; preceding += num_quotes[k++])
+        quoted[k] = preceding % 2;
+    run_in_parallel(num_chunks - 1, [&](std::size_t i) {
+        const std::size_t k = i + 1;
+        /* A boundary directly behind a newline outside quotes is already a record boundary.  The search for the end
+         * of the record must not start at an escaped character. */
+        const char *c = candidate(k);
+        if (c[-1] == '\n' and not quoted[k])
+            boundaries[k] = c;
+        else
+            boundaries[k] = find_record_end(c + is_escaped(begin, c, quote, escape), end, quote, escape, quoted[k]);
+    });
+
+    std::vector<CSV_chunk> chunks;
+    for (std::size_t k = 0; k != num_chunks; ++k) {
+        const char *chunk_begin = chunks.empty() ? begin : chunks.back().end;
+        const char *chunk_end = std::max(boundaries[k + 1], chunk_begin);
+        if (chunk_end != chunk_begin)
+            chunks.push_back({ chunk_begin, chunk_end });
+    }
+    return chunks;
+}
+
+std::size_t count_CSV_records(const CSV_chunk &chunk, char quote, char escape)
+{
+    std::size_t num_records = 0;
+    for (const char *p = chunk.begin; p != chunk.end; ++num_records)
+        p = find_record_end(p, chunk.end, quote, escape);
+    return num_records;
+}
+
+void parse_CSV_records(const CSV_chunk &chunk, std::size_t first_row, const Schema &schema, const DataLayout &layout,
+                       void *memory, char delimiter, char quote, char escape, bool vectorized)
+{
+    const std::size_t num_attrs = schema.num_entries();
+    std::vector<attribute_path> paths;
+    for (std::size_t attr = 0; attr != num_attrs; ++attr)
+        paths.push_back(compute_attribute_path(layout, attr));
+    std::optional<attribute_path> bitmap_path;
+    try {
+        bitmap_path = compute_attribute_path(layout, num_attrs);
+    } catch (const std::out_of_range&) {
+        /* the layout stores no NULL bitmap */
+    }
+
+    auto bytes = static_cast<uint8_t*>(memory);
+    /* Writes the value and the NULL bit of attribute `attr` of tuple `row`. */
+    auto write_field = [&](std::size_t row, uint64_t bitmap_offset, std::size_t attr, std::string_view field,
+                           bool is_null) {
+        if (is_null and not bitmap_path)
+            throw std::invalid_argument("NULL value in row " + std::to_string(row) + " of a layout without NULL "
+                                        "bitmap");
+        if (bitmap_path)
+            write_bit(bytes, bitmap_offset + attr, is_null);
+        if (not is_null)
+            write_value(bytes, paths[attr].offset_in_bits(row), schema[attr].type, field);
+    };
+
+    std::string unescaped;
+    if (vectorized) {
+        CSV_tokenizer tokenizer(chunk.begin, chunk.end, delimiter, quote, escape);
+        const char specials[] = { quote, escape, 0 };
+        for (std::size_t row = first_row; tokenizer.has_next(); ++row) {
+            const uint64_t bitmap_offset = bitmap_path ? bitmap_path->offset_in_bits(row) : 0;
+            for (std::size_t attr = 0; attr != num_attrs; ++attr) {
+                /* A delimiter at the very end of the chunk is followed by an empty last field. */
+                auto [field, is_last] = tokenizer.has_next() ? tokenizer.next() : CSV_field{ {}, true };
+                if (is_last != (attr + 1 == num_attrs))
+                    throw std::invalid_argument(std::string(is_last ? "too few" : "too many") + " fields in row " +
+                                                std::to_string(row));
+                if (is_last and not field.empty() and field.back() == '\r')
+                    field.remove_suffix(1);
+
+                bool is_null = false;
+                if (not field.empty() and field.front() == quote) {
+                    if (field.size() < 2 or field.back() != quote)
+                        throw std::invalid_argument("unterminated quoted field in row " + std::to_string(row));
+                    field = field.substr(1, field.size() - 2);
+                    if (field.find_first_of(specials) != std::string_view::npos) {
+                        /* Drop escape characters and replace doubled quotes by single ones.  An escape character
+                         * at the end escapes the closing quote, i.e. the field is unterminated. */
+                        unescaped.clear();
+                        for (std::size_t i = 0; i != field.size(); ++i) {
+                            if (field[i] == escape and escape != quote) {
+                                if (++i == field.size())
+                                    throw std::invalid_argument("unterminated quoted field in row " +
+                                                                std::to_string(row));
+                            } else if (field[i] == quote and i + 1 != field.size() and field[i + 1] == quote) {
+                                ++i; // doubled quote
+                            }
+                            unescaped += field[i];
+                        }
+                        field = unescaped;
+                    }
+                } else {
+                    is_null = field.empty();
+                }
+                write_field(row, bitmap_offset, attr, field, is_null);
+            }
+        }
+        return;
+    }
+
+    const char *p = chunk.begin;
+    for (std::size_t row = first_row; p != chunk.end; ++row) {
+        const uint64_t bitmap_offset = bitmap_path ? bitmap_path->offset_in_bits(row) : 0;
+        for (std::size_t attr = 0; attr != num_attrs; ++attr) {
+            /* Extract the field. */
+            std::string_view field;
+            bool is_null = false;
+            if (p != chunk.end and *p == quote) {
+                unescaped.clear();
+                for (++p;; ++p) {
+                    if (p == chunk.end)
+                        throw std::invalid_argument("unterminated quoted field in row " + std::to_string(row));
+                    if (*p == escape and escape != quote) {
+                        if (++p == chunk.end)
+                            throw std::invalid_argument("unterminated quoted field in row " + std::to_string(row));
+                        unescaped += *p; // escaped character
+                        continue;
+                    }
+                    if (*p == quote) {
+                        if (p + 1 == chunk.end or p[1] != quote)
+                            break;
+                        ++p; // escaped quote
+                    }
+                    unescaped += *p;
+                }
+                ++p; // closing quote
+                field = unescaped;
+            } else {
+                const char *field_end = p;
+                while (field_end != chunk.end and *field_end != delimiter and *field_end != '\n')
+                    ++field_end;
+                field = std::string_view(p, field_end - p);
+                if (not field.empty() and field.back() == '\r')
+                    field.remove_suffix(1);
+                is_null = field.empty();
+                p = field_end;
+            }
+
+            /* Expect the delimiter, or the end of the record after the last field. */
+            if (attr + 1 != num_attrs) {
+                if (p == chunk.end or *p != delimiter)
+                    throw std::invalid_argument("too few fields in row " + std::to_string(row));
+                ++p;
+            } else {
+                if (p != chunk.end and *p == '\r')
+                    ++p;
+                if (p != chunk.end and *p != '\n')
+                    throw std::invalid_argument("too many fields in row " + std::to_string(row));
+                if (p != chunk.end)
+                    ++p;
+            }
+
+            write_field(row, bitmap_offset, attr, field, is_null);
+        }
+    }
+}
+
+std::size_t load_CSV_parallel(Table &table, const std::filesystem::path &path, unsigned num_threads, bool has_header,
+                              char delimiter, char quote, char escape, bool vectorized)
+{
+    mapped_file file(path);
+    const char *begin = file.data, *end = file.data + file.size;
+    if (has_header)
+        begin = find_record_end(begin, end, quote, escape);
+
+    /* Split the file, count the records of every chunk, and derive the row of the first record of every chunk. */
+    const auto chunks = split_CSV(begin, end, std::max(num_threads, 1U), quote, escape);
+    std::vector<std::size_t> first_rows(chunks.size() + 1);
+    run_in_parallel(chunks.size(), [&](std::size_t i) {
+        first_rows[i + 1] = count_CSV_records(chunks[i], quote, escape);
+    });
+    first_rows[0] = table.store().num_rows();
+    for (std::size_t i = 1; i != first_rows.size(); ++i)
+        first_rows[i] += first_rows[i - 1];
+    const std::size_t num_rows = first_rows.back() - first_rows.front();
+
+    /* Allocate the rows in the store and let every thread parse its chunk into them. */
+    auto &store = table.store();
+    for (std::size_t i = 0; i != num_rows; ++i)
+        store.append();
+    const auto schema = table.schema();
+    run_in_parallel(chunks.size(), [&](std::size_t i) {
+        parse_CSV_records(chunks[i], first_rows[i], schema, table.layout(), store.memory().addr(), delimiter, quote,
+                          escape, vectorized);
+    });
+
+    return num_rows;
+}
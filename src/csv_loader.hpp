@@ -0,0 +1,45 @@
+#pragma once
+
+#include "data_layouts.hpp"
+#include <cstddef>
+#include <filesystem>
+#include <mutable/mutable.hpp>
+#include <vector>
+
+
+/** A range of whole records of a CSV file. */
+struct CSV_chunk
+{
+    const char *begin;
+    const char *end;
+};
+
+/** Splits the CSV data in [\p begin, \p end) into at most \p num_chunks chunks of roughly equal size at record
+ * boundaries, i.e. at newlines outside of fields enclosed in \p quote.  Whether a candidate boundary is inside a quoted
+ * field is derived from the parity of the number of quotes preceding it, which is counted in parallel.  Quotes preceded
+ * by an odd number of \p escape characters are escaped and not counted.  An \p escape equal to \p quote disables
+ * escaping, leaving only doubled quotes. */
+std::vector<CSV_chunk> split_CSV(const char *begin, const char *end, std::size_t num_chunks, char quote = '"',
+                                 char escape = '\\');
+
+/** Returns the number of records in \p chunk. */
+std::size_t count_CSV_records(const CSV_chunk &chunk, char quote = '"', char escape = '\\');
+
+/** Parses the records of \p chunk into the tuples \p first_row, \p first_row + 1, ... of \p schema stored in \p layout
+ * at \p memory.  The memory of these tuples must already be allocated.  Empty unquoted fields are NULL.  Within quoted
+ * fields, \p escape makes the next character literal, like in `m::load_from_CSV()`, and doubled quotes are single ones.
+ * Supports Booleans, integers, decimals, floating-point numbers, and character sequences.  If \p vectorized, fields are
+ * split with the SIMD `CSV_tokenizer`, otherwise byte by byte.  Throws `std::invalid_argument` on malformed records and
+ * values of unsupported types. */
+void parse_CSV_records(const CSV_chunk &chunk, std::size_t first_row, const m::Schema &schema,
+                       const m::storage::DataLayout &layout, void *memory, char delimiter = ',', char quote = '"',
+                       char escape = '\\', bool vectorized = false);
+
+/** Loads the CSV file \p path into \p table using \p num_threads threads, like `m::load_from_CSV()` does with a single
+ * thread.  The file is memory-mapped and split into one chunk per thread.  Every thread parses its chunk directly into
+ * the blocks of the table's layout in the table's store.  If \p has_header, the first record is skipped.  If
+ * \p vectorized, fields are split with the SIMD `CSV_tokenizer`.  Returns the number of tuples loaded.  Throws
+ * `std::runtime_error` if the file cannot be read. */
+std::size_t load_CSV_parallel(m::Table &table, const std::filesystem::path &path, unsigned num_threads,
+                              bool has_header = true, char delimiter = ',', char quote = '"', char escape = '\\',
+                              bool vectorized = false);
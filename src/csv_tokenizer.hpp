@@ -0,0 +1,153 @@
+#pragma once
+
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+
+/** A field of a CSV record, as returned by a tokenizer. */
+struct CSV_field
+{
+    std::string_view data; ///< the raw field, i.e. including enclosing quotes and escaped (doubled) quotes
+    bool is_last; ///< whether the field is the last one of its record
+};
+
+/** Splits the CSV data in [\p begin, \p end), which must start outside a quoted field, into fields.  The data is
+ * processed 64 bytes at a time: bitmasks of the delimiters, newlines, and quotes of a block are computed with AVX2 or
+ * SSE2 comparisons, or a scalar loop if neither is available.  Quotes preceded by an odd number of escape characters are
+ * escaped and cleared from the quote mask.  The mask of bytes inside quoted fields is the prefix XOR of the quote mask,
+ * carried over from block to block, and masks out delimiters and newlines within quoted fields.  Fields are then found
+ * by counting trailing zeros instead of inspecting every byte. */
+struct CSV_tokenizer
+{
+    static constexpr std::size_t BLOCK_SIZE = 64;
+
+    private:
+    const char *pos_; ///< the beginning of the next field
+    const char *end_;
+    char delimiter_;
+    char quote_;
+    char escape_; ///< equal to `quote_` if escaping is disabled
+    const char *block_; ///< the beginning of the next block
+    const char *current_block_ = nullptr; ///< the beginning of the block of `separators_`
+    uint64_t separators_ = 0; ///< unprocessed delimiters and newlines outside quoted fields in the current block
+    uint64_t in_quotes_carry_ = 0; ///< all ones iff the current block ends inside a quoted field
+    uint64_t escaped_carry_ = 0; ///< 1 iff the first byte of the next block is escaped
+
+    public:
+    CSV_tokenizer(const char *begin, const char *end, char delimiter = ',', char quote = '"', char escape = '\\')
+        : pos_(begin), end_(end), delimiter_(delimiter), quote_(quote), escape_(escape), block_(begin)
+    { }
+
+    /** Returns `true` iff there are more fields. */
+    bool has_next() const { return pos_ != end_; }
+
+    /** Returns the next field.  Must only be called if `has_next()`. */
+    CSV_field next()
+    {
+        const char *separator = find_separator();
+        CSV_field field{ std::string_view(pos_, separator - pos_), separator == end_ or *separator == '\n' };
+        pos_ = separator == end_ ? end_ : separator + 1;
+        return field;
+    }
+
+    private:
+    /** Returns the position of the next delimiter or newline outside a quoted field, or the end. */
+    const char * find_separator()
+    {
+        while (not separators_) {
+            if (block_ >= end_)
+                return end_;
+            load_block();
+        }
+        const char *separator = current_block_ + std::countr_zero(separators_);
+        separators_ &= separators_ - 1; // clear the lowest set bit
+        return separator;
+    }
+
+    /** Computes the separators of the next block. */
+    void load_block()
+    {
+        const char *data = block_;
+        alignas(BLOCK_SIZE) char padded[BLOCK_SIZE];
+        if (end_ - block_ < std::ptrdiff_t(BLOCK_SIZE)) {
+            /* Pad the last block with bytes that are neither delimiter, newline, nor quote. */
+            std::memset(padded, 0, BLOCK_SIZE);
+            std::memcpy(padded, block_, end_ - block_);
+            data = padded;
+        }
+
+        uint64_t quotes = equal_mask(data, quote_);
+        if (escape_ != quote_)
+            quotes &= ~escaped_mask(equal_mask(data, escape_));
+        const uint64_t in_quotes = prefix_xor(quotes) ^ in_quotes_carry_;
+        in_quotes_carry_ = uint64_t(int64_t(in_quotes) >> 63);
+        separators_ = (equal_mask(data, delimiter_) | equal_mask(data, '\n')) & ~in_quotes;
+
+        current_block_ = block_;
+        block_ += BLOCK_SIZE;
+    }
+
+    /** Returns a mask with bit `i` set iff byte `i` of the block at \p data equals \p c. */
+    static uint64_t equal_mask(const char *data, char c)
+    {
+#if defined(__AVX2__)
+        const __m256i needle = _mm256_set1_epi8(c);
+        const __m256i lo = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data));
+        const __m256i hi = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + 32));
+        return uint64_t(uint32_t(_mm256_movemask_epi8(_mm256_cmpeq_epi8(lo, needle)))) |
+               uint64_t(uint32_t(_mm256_movemask_epi8(_mm256_cmpeq_epi8(hi, needle)))) << 32;
+#elif defined(__SSE2__)
+        const __m128i needle = _mm_set1_epi8(c);
+        uint64_t mask = 0;
+        for (std::size_t i = 0; i != BLOCK_SIZE / 16; ++i) {
+            const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 16 * i));
+            mask |= uint64_t(uint16_t(_mm_movemask_epi8(_mm_cmpeq_epi8(v, needle)))) << (16 * i);
+        }
+        return mask;
+#else
+        uint64_t mask = 0;
+        for (std::size_t i = 0; i != BLOCK_SIZE; ++i)
+            mask |= uint64_t(data[i] == c) << i;
+        return mask;
+#endif
+    }
+
+    /** Returns a mask with bit `i` set iff byte `i` of the block is escaped, i.e. preceded by an odd number of escape
+     * characters, given the mask \p escapes of the escape characters of the block.  Runs of escape characters are
+     * classified without a loop: adding the first escape character of every run that starts at an odd position to
+     * the escape mask carries over the run and sets the bit behind it; the parity of the start and the end of a run
+     * then tells whether the byte behind it is escaped (after simdjson). */
+    uint64_t escaped_mask(uint64_t escapes)
+    {
+        constexpr uint64_t EVEN_BITS = 0x5555555555555555ULL;
+        escapes &= ~escaped_carry_; // an escaped escape character escapes nothing
+        const uint64_t follows_escape = escapes << 1 | escaped_carry_;
+        const uint64_t odd_starts = escapes & ~EVEN_BITS & ~follows_escape;
+        uint64_t sequences_starting_on_even_bits;
+        escaped_carry_ = __builtin_add_overflow(odd_starts, escapes, &sequences_starting_on_even_bits);
+        const uint64_t invert_mask = sequences_starting_on_even_bits << 1;
+        return (EVEN_BITS ^ invert_mask) & follows_escape;
+    }
+
+    /** Returns a mask with bit `i` set iff an odd number of bits `0..i` of \p x are set. */
+    static uint64_t prefix_xor(uint64_t x)
+    {
+#if defined(__PCLMUL__)
+        return _mm_cvtsi128_si64(_mm_clmulepi64_si128(_mm_set_epi64x(0, x), _mm_set1_epi8(-1), 0));
+#else
+        x ^= x << 1;
+        x ^= x << 2;
+        x ^= x << 4;
+        x ^= x << 8;
+        x ^= x << 16;
+        x ^= x << 32;
+        return x;
+#endif
+    }
+};
@@ -1,35 +1,78 @@
 #include "data_layouts.hpp"
+#include <bit>
+#include <cctype>
+#include <fstream>
+#include <iterator>
+#include <limits>
 #include <numeric>
+#include <stdexcept>
+#include <string>
 
 
 using namespace m;
 using namespace m::storage;
 
 
+namespace {
+
+/** Rounds \p offset up to the next multiple of \p alignment. */
+uint64_t align_up(uint64_t offset, uint64_t alignment)
+{
+    return offset % alignment ? (offset / alignment + 1) * alignment : offset;
+}
+
+/** Returns the offset of the first padding hole of at least \p size bits between the attribute \p extents, given as
+ * `[begin, end)` offsets, or the end of the last extent if there is no such hole. */
+uint64_t find_padding_hole(std::vector<std::pair<uint64_t, uint64_t>> extents, uint64_t size)
+{
+    std::sort(extents.begin(), extents.end());
+    uint64_t end = 0;
+    for (auto [begin_of_attr, end_of_attr] : extents) {
+        if (begin_of_attr >= end + size)
+            return end;
+        end = std::max(end, end_of_attr);
+    }
+    return end;
+}
+
+}
+
 DataLayout MyNaiveRowLayoutFactory::make(std::vector<const Type*> types, std::size_t num_tuples) const
 {
     // TODO 1.2: implement computing a row layout
     DataLayout DL;
 
-    // Computing inode stride
-    int INode_stride = 0;
+    // Computing offsets of the leaves and the inode stride
+    uint64_t cur_offset = 0;
     uint64_t max_elem_alignemnt = 1;
+    std::vector<uint64_t> offset(types.size());
+    std::vector<std::pair<uint64_t, uint64_t>> extents;
 
-    for (auto& type : types){
+    for (std::size_t idx = 0; idx != types.size(); ++idx){
+        auto type = types[idx];
         // updating max alignemnt seen until now
         max_elem_alignemnt = std::max(max_elem_alignemnt, type->alignment());
 
-        // extending inode stride by the size + padding of current type (leaf in feature)
-        if(INode_stride % type->alignment())
-            INode_stride = (INode_stride / type->alignment() + 1) * type->alignment();
-        INode_stride += type->size();
+        // beginning of current leaf should by a multiply of the leaf's alignment
+        if(cur_offset % type->alignment())
+            cur_offset = (cur_offset / type->alignment() + 1) * type->alignment();
+
+        offset[idx] = cur_offset;
+        extents.emplace_back(cur_offset, cur_offset + type->size());
+
+        // computing offset for next leaf
+        cur_offset += type->size();
     }
 
     // Since minimum memory unit access is Byte, alignemnt could not be smaller
     max_elem_alignemnt = std::max(max_elem_alignemnt, uint64_t(8));
 
-    // adding enough stride for NULL BITMAP
-    INode_stride += types.size();
+    // placing the NULL BITMAP, one bit per attribute, into the first padding hole large enough
+    uint64_t INode_stride = cur_offset, bitmap_offset = 0;
+    if (nullable_) {
+        bitmap_offset = find_padding_hole(extents, types.size());
+        INode_stride = std::max(INode_stride, bitmap_offset + types.size());
+    }
 
     // IF the stride is not a multiply of alignment, rounding it up to next multiply of max alignment
     if(INode_stride % max_elem_alignemnt)
@@ -39,21 +82,12 @@ DataLayout MyNaiveRowLayoutFactory::make(std::vector<const Type*> types, std::si
     auto &row = DL.add_inode(1, INode_stride);
 
     // Adding leafs to inode
-    int cur_offset = 0, idx = 0;
+    for (std::size_t idx = 0; idx != types.size(); ++idx)
+        row.add_leaf(types[idx], idx, offset[idx], 0);
 
-    for (auto& type : types){
-        // beginning of current lead should by a multiply of the leaf's alignment
-        if(cur_offset % type->alignment())
-            cur_offset = (cur_offset / type->alignment() + 1) * type->alignment();
-
-        row.add_leaf(type, idx++, cur_offset, 0);
-
-        // computing offset for next leaf
-        cur_offset += type->size();
-    }
-    
     // Bitmap leaf
-    row.add_leaf(Type::Get_Bitmap(Type::TY_Vector, idx), idx, cur_offset, 0);
+    if (nullable_)
+        row.add_leaf(Type::Get_Bitmap(Type::TY_Vector, types.size()), types.size(), bitmap_offset, 0);
 
     return DL;
 }
@@ -73,23 +107,33 @@ DataLayout MyOptimizedRowLayoutFactory::make(std::vector<const Type*> types, std
     });
     DataLayout DL;
 
-    // Computing inode stride
-    int INode_stride = 0;
-    uint64_t max_elem_alignemnt = types_indices.front().first->alignment();
+    // calculating offset of types before sorting them to initial order
+    uint64_t cur_offset = 0;
+    uint64_t max_elem_alignemnt = types_indices.empty() ? 1 : types_indices.front().first->alignment();
+    std::vector<uint64_t> offset(types.size());
+    std::vector<std::pair<uint64_t, uint64_t>> extents;
 
     for (auto& type : types_indices){
-        // extending inode stride by the size + padding of current type (leaf in feature)
-        if(INode_stride % type.first->alignment())
-            INode_stride = (INode_stride / type.first->alignment() + 1) * type.first->alignment();
+        // beginning of current lead should by a multiply of the leaf's alignment
+        if(cur_offset % type.first->alignment())
+            cur_offset = (cur_offset / type.first->alignment() + 1) * type.first->alignment();
+
+        offset[type.second] = cur_offset;
+        extents.emplace_back(cur_offset, cur_offset + type.first->size());
 
-        INode_stride += type.first->size();
+        // computing offset for next leaf
+        cur_offset += type.first->size();
     }
 
     // Since minimum memory unit access is Byte, alignemnt could not be smaller
     max_elem_alignemnt = std::max(max_elem_alignemnt, uint64_t(8));
 
-    // adding enough stride for NULL BITMAP
-    INode_stride += types.size();
+    // placing the NULL BITMAP, one bit per attribute, into the first padding hole large enough
+    uint64_t INode_stride = cur_offset, bitmap_offset = 0;
+    if (nullable_) {
+        bitmap_offset = find_padding_hole(extents, types.size());
+        INode_stride = std::max(INode_stride, bitmap_offset + types.size());
+    }
 
     // IF the stride is not a multiply of alignment, rounding it up to next multiply of alignment
     if(INode_stride % max_elem_alignemnt)
@@ -98,22 +142,6 @@ DataLayout MyOptimizedRowLayoutFactory::make(std::vector<const Type*> types, std
     // Creading the inode
     auto &row = DL.add_inode(1, INode_stride);
 
-    
-    // calculating offset of types before sorting them to initial order
-    int cur_offset = 0;
-    std::vector<int> offset(types.size());
-
-    for (auto& type : types_indices){
-        // beginning of current lead should by a multiply of the leaf's alignment
-        if(cur_offset % type.first->alignment())
-            cur_offset = (cur_offset / type.first->alignment() + 1) * type.first->alignment();
-
-        offset[type.second] = cur_offset;
-
-        // computing offset for next leaf
-        cur_offset += type.first->size();
-    }
-
     //sorting types to initial order
     std::sort(types_indices.begin(), types_indices.end(), [](auto a, auto b) {
         return a.second < b.second;
@@ -125,14 +153,231 @@ DataLayout MyOptimizedRowLayoutFactory::make(std::vector<const Type*> types, std
         row.add_leaf(type.first, type.second, offset[type.second], 0);
     
     // Bitmap leaf
-    row.add_leaf(Type::Get_Bitmap(Type::TY_Vector, types.size()), types.size(), cur_offset, 0);
+    if (nullable_)
+        row.add_leaf(Type::Get_Bitmap(Type::TY_Vector, types.size()), types.size(), bitmap_offset, 0);
 
     return DL;
 }
 
-DataLayout MyPAX4kLayoutFactory::make(std::vector<const Type*> types, std::size_t num_tuples) const
+namespace {
+
+/** Places the attributes \p attrs of \p types one after another, beginning at \p start_offset, such that the end of the
+ * last attribute is minimal.  Writes the offset of each attribute to \p offset and returns the end.  The order is found
+ * exactly by dynamic programming over the subsets of placed attributes if there are at most `limit` attributes, and
+ * by sorting by descending alignment otherwise. */
+uint64_t pack_attributes(const std::vector<const Type*> &types, std::vector<std::size_t> attrs, uint64_t start_offset,
+                         std::size_t limit, std::vector<uint64_t> &offset)
+{
+    const std::size_t n = attrs.size();
+    std::vector<std::size_t> order;
+
+    if (n <= limit) {
+        // minimal end offset when placing a subset of the attributes first, and the attribute placed last
+        constexpr uint64_t UNREACHED = std::numeric_limits<uint64_t>::max();
+        std::vector<uint64_t> end(std::size_t(1) << n, UNREACHED);
+        std::vector<uint8_t> last(std::size_t(1) << n);
+        end[0] = start_offset;
+        for (std::size_t placed = 0; placed != end.size(); ++placed) {
+            for (std::size_t i = 0; i != n; ++i) {
+                if (placed & (std::size_t(1) << i))
+                    continue;
+                const std::size_t next = placed | (std::size_t(1) << i);
+                const uint64_t end_of_attr = align_up(end[placed], types[attrs[i]]->alignment()) +
+                                             types[attrs[i]]->size();
+                if (end_of_attr < end[next]) {
+                    end[next] = end_of_attr;
+                    last[next] = i;
+                }
+            }
+        }
+        for (std::size_t placed = end.size() - 1; placed; placed &= ~(std::size_t(1) << last[placed]))
+            order.push_back(attrs[last[placed]]);
+        std::reverse(order.begin(), order.end());
+    } else {
+        order = std::move(attrs);
+        std::stable_sort(order.begin(), order.end(), [&types](auto a, auto b) {
+            return types[a]->alignment() > types[b]->alignment();
+        });
+    }
+
+    uint64_t cur_offset = start_offset;
+    for (auto idx : order) {
+        cur_offset = align_up(cur_offset, types[idx]->alignment());
+        offset[idx] = cur_offset;
+        cur_offset += types[idx]->size();
+    }
+    return cur_offset;
+}
+
+/** Returns the stride of rows of \p size_in_bits such that rows do not straddle cache lines: the next power of two (at
+ * least one byte) for rows of at most a cache line, and a multiple of the cache line size otherwise. */
+uint64_t cache_line_stride(uint64_t size_in_bits)
+{
+    constexpr uint64_t LINE = MyCacheAlignedRowLayoutFactory::CACHE_LINE_IN_BITS;
+    return size_in_bits <= LINE ? std::bit_ceil(std::max<uint64_t>(size_in_bits, 8)) : align_up(size_in_bits, LINE);
+}
+
+}
+
+DataLayout MyPackedRowLayoutFactory::make(std::vector<const Type*> types, std::size_t num_tuples) const
+{
+    std::vector<uint64_t> offset(types.size());
+    std::vector<bool> is_grouped(types.size());
+    uint64_t cur_offset = 0;
+
+    // placing the groups, each one starting at the next cache line if it would cross one otherwise
+    for (auto &group : groups_) {
+        std::vector<std::size_t> attrs;
+        for (auto idx : group) {
+            if (idx < types.size() and not is_grouped[idx]) {
+                attrs.push_back(idx);
+                is_grouped[idx] = true;
+            }
+        }
+        if (attrs.empty())
+            continue;
+
+        const uint64_t begin_of_group = cur_offset;
+        cur_offset = pack_attributes(types, attrs, begin_of_group, EXACT_LIMIT, offset);
+        const uint64_t line_of_group = begin_of_group / CACHE_LINE_IN_BITS;
+        if (cur_offset - begin_of_group <= CACHE_LINE_IN_BITS and (cur_offset - 1) / CACHE_LINE_IN_BITS != line_of_group)
+            cur_offset = pack_attributes(types, attrs, (line_of_group + 1) * CACHE_LINE_IN_BITS, EXACT_LIMIT, offset);
+    }
+
+    // placing all remaining attributes
+    std::vector<std::size_t> remaining;
+    for (std::size_t idx = 0; idx != types.size(); ++idx) {
+        if (not is_grouped[idx])
+            remaining.push_back(idx);
+    }
+    cur_offset = pack_attributes(types, remaining, cur_offset, EXACT_LIMIT, offset);
+
+    // placing the NULL BITMAP into the first padding hole large enough
+    uint64_t INode_stride = cur_offset, bitmap_offset = 0;
+    if (nullable_) {
+        std::vector<std::pair<uint64_t, uint64_t>> extents;
+        for (std::size_t idx = 0; idx != types.size(); ++idx)
+            extents.emplace_back(offset[idx], offset[idx] + types[idx]->size());
+        bitmap_offset = find_padding_hole(extents, types.size());
+        INode_stride = std::max(INode_stride, bitmap_offset + types.size());
+    }
+
+    // rounding the stride up to the maximal alignment, at least one byte
+    uint64_t max_elem_alignment = 8;
+    for (auto type : types)
+        max_elem_alignment = std::max(max_elem_alignment, type->alignment());
+    INode_stride = align_up(INode_stride, max_elem_alignment);
+
+    // keeping the groups within a cache line in every row, not only in the first one
+    if (not groups_.empty())
+        INode_stride = cache_line_stride(INode_stride);
+
+    DataLayout DL;
+    auto &row = DL.add_inode(1, INode_stride);
+    for (std::size_t idx = 0; idx != types.size(); ++idx)
+        row.add_leaf(types[idx], idx, offset[idx], 0);
+
+    // Bitmap leaf
+    if (nullable_)
+        row.add_leaf(Type::Get_Bitmap(Type::TY_Vector, types.size()), types.size(), bitmap_offset, 0);
+
+    return DL;
+}
+
+namespace {
+
+/** Returns `true` iff the subtree of \p inode contains the leaf of attribute \p attr. */
+bool contains_attribute(const DataLayout::INode &inode, std::size_t attr)
+{
+    for (std::size_t i = 0; i != inode.num_children(); ++i) {
+        auto node = inode.at(i).ptr.get();
+        if (auto leaf = cast<const DataLayout::Leaf>(node); leaf and leaf->index() == attr)
+            return true;
+        if (auto child = cast<const DataLayout::INode>(node); child and contains_attribute(*child, attr))
+            return true;
+    }
+    return false;
+}
+
+}
+
+DataLayout MyCacheAlignedRowLayoutFactory::make(std::vector<const Type*> types, std::size_t num_tuples) const
+{
+    const std::size_t bitmap_size = nullable_ ? types.size() : 0;
+    std::vector<uint64_t> offset(types.size());
+
+    /* Packs the attributes \p attrs into a row and places the NULL bitmap in the first padding hole large enough, if
+     * \p with_bitmap.  Returns the end of the row and the offset of the bitmap. */
+    auto pack_row = [&](const std::vector<std::size_t> &attrs, bool with_bitmap) {
+        uint64_t end = pack_attributes(types, attrs, 0, MyPackedRowLayoutFactory::EXACT_LIMIT, offset);
+        uint64_t bitmap_offset = 0;
+        if (with_bitmap) {
+            std::vector<std::pair<uint64_t, uint64_t>> extents;
+            for (auto idx : attrs)
+                extents.emplace_back(offset[idx], offset[idx] + types[idx]->size());
+            bitmap_offset = find_padding_hole(extents, bitmap_size);
+            end = std::max(end, bitmap_offset + bitmap_size);
+        }
+        return std::make_pair(end, bitmap_offset);
+    };
+
+    // splitting attributes into hot and cold ones
+    std::vector<std::size_t> all(types.size()), hot, cold;
+    std::iota(all.begin(), all.end(), 0);
+    for (auto idx : all)
+        (std::find(hot_.begin(), hot_.end(), idx) != hot_.end() ? hot : cold).push_back(idx);
+
+    DataLayout DL;
+    auto [row_end, bitmap_offset] = pack_row(all, nullable_);
+
+    // a single row sub-block, if the row fits into a cache line or there is nothing to split
+    if (row_end <= CACHE_LINE_IN_BITS or hot.empty() or cold.empty()) {
+        auto &row = DL.add_inode(1, cache_line_stride(row_end));
+        for (auto idx : all)
+            row.add_leaf(types[idx], idx, offset[idx], 0);
+        if (nullable_)
+            row.add_leaf(Type::Get_Bitmap(Type::TY_Vector, types.size()), types.size(), bitmap_offset, 0);
+        return DL;
+    }
+
+    // the NULL bitmap goes with the hot attributes, unless it would push them beyond a cache line
+    auto [hot_end, hot_bitmap_offset] = pack_row(hot, nullable_);
+    const bool bitmap_is_hot = nullable_ and hot_end <= CACHE_LINE_IN_BITS;
+    if (nullable_ and not bitmap_is_hot)
+        hot_end = pack_row(hot, false).first;
+    auto [cold_end, cold_bitmap_offset] = pack_row(cold, nullable_ and not bitmap_is_hot);
+
+    // the cold rows are padded to their maximal alignment, at least one byte
+    uint64_t cold_alignment = 8;
+    for (auto idx : cold)
+        cold_alignment = std::max(cold_alignment, types[idx]->alignment());
+    const uint64_t hot_stride = cache_line_stride(hot_end), cold_stride = align_up(cold_end, cold_alignment);
+
+    auto &block = DL.add_inode(TUPLES_PER_BLOCK, TUPLES_PER_BLOCK * (hot_stride + cold_stride));
+    auto &hot_row = block.add_inode(1, 0, hot_stride);
+    auto &cold_row = block.add_inode(1, TUPLES_PER_BLOCK * hot_stride, cold_stride);
+    for (auto idx : hot)
+        hot_row.add_leaf(types[idx], idx, offset[idx], 0);
+    for (auto idx : cold)
+        cold_row.add_leaf(types[idx], idx, offset[idx], 0);
+
+    // Bitmap leaf
+    if (nullable_) {
+        (bitmap_is_hot ? hot_row : cold_row).add_leaf(Type::Get_Bitmap(Type::TY_Vector, types.size()), types.size(),
+                                                      bitmap_is_hot ? hot_bitmap_offset : cold_bitmap_offset, 0);
+    }
+
+    return DL;
+}
+
+DataLayout MyPAXLayoutFactory::make(std::vector<const Type*> types, std::size_t num_tuples) const
 {
     // TODO 1.4: implement computing a PAX layout
+    return make_blocks(std::move(types), 0);
+}
+
+DataLayout MyPAXLayoutFactory::make_blocks(std::vector<const Type*> types, uint64_t header_size_in_bits) const
+{
     // storing initial indices
     std::vector<std::pair<const Type*, int>> types_indices;
     for (unsigned long ind = 0; ind < types.size(); ind++)
@@ -145,36 +390,34 @@ DataLayout MyPAX4kLayoutFactory::make(std::vector<const Type*> types, std::size_
     DataLayout DL;
 
     // Computing inode stride
-    int INode_stride = 4096 * 8, row_length = 0;
-    uint64_t max_elem_alignemnt = types_indices.front().first->alignment();
+    uint64_t INode_stride = block_size_in_bytes_ * 8, row_length = 0;
 
     for (auto& type : types_indices){
         // extending inode stride by the size + padding of current type (leaf in feature)
         if(row_length % type.first->alignment())
-            row_length = (INode_stride / type.first->alignment() + 1) * type.first->alignment();
+            row_length = (row_length / type.first->alignment() + 1) * type.first->alignment();
 
         row_length += type.first->size();
     }
 
-    // Since minimum memory unit access is Byte, alignemnt could not be smaller
-    max_elem_alignemnt = std::max(max_elem_alignemnt, uint64_t(8));
-
     // adding enough stride for NULL BITMAP
     row_length += types.size();
 
-    // Creading the inode
-    auto &row = DL.add_inode(INode_stride / row_length, INode_stride);
+    // Creading the inode, the minipages share the block with the header
+    M_insist(row_length != 0, "a PAX block requires at least one attribute");
+    M_insist(header_size_in_bits + row_length <= INode_stride, "the block size is too small to fit a single tuple");
+    const std::size_t tuples_per_block = (INode_stride - header_size_in_bits) / row_length;
+    auto &row = DL.add_inode(tuples_per_block, INode_stride);
 
-    
-    // calculating offset of types before sorting them to initial order
-    int cur_offset = 0;
-    std::vector<int> offset(types.size());
+    // calculating offset of types before sorting them to initial order, the minipages start behind the header
+    uint64_t cur_offset = header_size_in_bits;
+    std::vector<uint64_t> offset(types.size());
 
     for (auto& type : types_indices){
         offset[type.second] = cur_offset;
 
         // computing offset for next leaf
-        cur_offset += type.first->size() * (INode_stride / row_length);
+        cur_offset += type.first->size() * tuples_per_block;
     }
 
     //sorting types to initial order
@@ -187,8 +430,256 @@ DataLayout MyPAX4kLayoutFactory::make(std::vector<const Type*> types, std::size_
     for (auto& type : types_indices)
         row.add_leaf(type.first, type.second, offset[type.second], type.first->size());
     
+    // Bitmap leaf, one bitmap of all attributes per tuple
+    row.add_leaf(Type::Get_Bitmap(Type::TY_Vector, types.size()), types.size(), cur_offset, types.size());
+
+    return DL;
+}
+
+DataLayout MyPAXZoneMapLayoutFactory::make(std::vector<const Type*> types, std::size_t num_tuples) const
+{
+    const auto num_synopses = std::count_if(types.begin(), types.end(), has_synopsis);
+    return make_blocks(std::move(types), num_synopses * SYNOPSIS_SIZE_IN_BITS);
+}
+
+namespace {
+
+/** Reads the size in bytes of the cache of the given \p level and \p type (`Data` or `Unified`) of the first CPU from
+ * sysfs.  Returns 0 if the size is not available. */
+std::size_t read_cache_size(unsigned level, const char *type)
+{
+    for (unsigned index = 0; ; ++index) {
+        const std::string dir = "/sys/devices/system/cpu/cpu0/cache/index" + std::to_string(index) + '/';
+        std::ifstream in_level(dir + "level"), in_type(dir + "type"), in_size(dir + "size");
+        if (not in_level or not in_type or not in_size)
+            return 0; // no more caches
+
+        unsigned cache_level;
+        std::string cache_type, cache_size;
+        if (not (in_level >> cache_level) or not (in_type >> cache_type) or not (in_size >> cache_size))
+            continue;
+        if (cache_level != level or cache_type != type)
+            continue;
+
+        // size is given as e.g. `48K` or `2M`
+        std::size_t pos;
+        std::size_t size = std::stoul(cache_size, &pos);
+        switch (pos < cache_size.size() ? cache_size[pos] : 0) {
+            case 'K': return size * 1024;
+            case 'M': return size * 1024 * 1024;
+            default:  return size;
+        }
+    }
+}
+
+}
+
+MyPAXAutoLayoutFactory::MyPAXAutoLayoutFactory()
+    : MyPAXAutoLayoutFactory(read_cache_size(1, "Data"), read_cache_size(2, "Unified"))
+{ }
+
+std::size_t MyPAXAutoLayoutFactory::block_size_in_bytes(uint64_t tuple_size_in_bits) const
+{
+    // the largest power of two fitting in L1d, or the smallest block if L1d is unknown
+    std::size_t block_size = MIN_BLOCK_SIZE;
+    while (2 * block_size <= std::min(L1d_size_in_bytes_, MAX_BLOCK_SIZE))
+        block_size *= 2;
+
+    // for wide tuples, growing the block as long as half of L2 is not exceeded; tuples without attributes fit anywhere
+    while (tuple_size_in_bits != 0 and block_size * 8 / tuple_size_in_bits < MIN_TUPLES_PER_BLOCK and
+           2 * block_size <= std::min(L2_size_in_bytes_ / 2, MAX_BLOCK_SIZE))
+        block_size *= 2;
+
+    return block_size;
+}
+
+DataLayout MyPAXAutoLayoutFactory::make(std::vector<const Type*> types, std::size_t num_tuples) const
+{
+    // size of a tuple within a block, including its bit in the NULL bitmap
+    uint64_t tuple_size = types.size();
+    for (auto type : types)
+        tuple_size += type->size();
+
+    return MyPAXLayoutFactory(block_size_in_bytes(tuple_size)).make(std::move(types), num_tuples);
+}
+
+DataLayout MyDSMLayoutFactory::make(std::vector<const Type*> types, std::size_t num_tuples) const
+{
+    // 512 tuples of any type size, in bits, fill whole cache lines
+    const uint64_t tuples_per_block = num_tuples ? align_up(num_tuples, ALIGNMENT_IN_BITS) : DEFAULT_TUPLES_PER_BLOCK;
+
+    // computing the offset of each column, each starting at a cache line
+    uint64_t cur_offset = 0;
+    std::vector<uint64_t> offset(types.size() + 1);
+    for (std::size_t idx = 0; idx != types.size(); ++idx) {
+        offset[idx] = cur_offset;
+        cur_offset = align_up(cur_offset + types[idx]->size() * tuples_per_block, ALIGNMENT_IN_BITS);
+    }
+    offset[types.size()] = cur_offset;
+    cur_offset = align_up(cur_offset + types.size() * tuples_per_block, ALIGNMENT_IN_BITS);
+
+    DataLayout DL;
+    auto &block = DL.add_inode(tuples_per_block, cur_offset);
+
+    for (std::size_t idx = 0; idx != types.size(); ++idx)
+        block.add_leaf(types[idx], idx, offset[idx], types[idx]->size());
+
+    // Bitmap column
+    block.add_leaf(Type::Get_Bitmap(Type::TY_Vector, types.size()), types.size(), offset[types.size()], types.size());
+
+    return DL;
+}
+
+DataLayout MyHybridLayoutFactory::make(std::vector<const Type*> types, std::size_t num_tuples) const
+{
+    // splitting attributes into hot and cold ones, keeping their initial indices
+    std::vector<std::pair<const Type*, int>> hot, cold;
+    for (unsigned long ind = 0; ind < types.size(); ind++)
+        (is_hot(ind) ? hot : cold).push_back(std::make_pair(types[ind], ind));
+
+    // sorting both groups in descending order of their alignment
+    auto by_alignment = [](auto a, auto b) { return a.first->alignment() > b.first->alignment(); };
+    std::stable_sort(hot.begin(), hot.end(), by_alignment);
+    std::stable_sort(cold.begin(), cold.end(), by_alignment);
+
+    // computing the stride of the hot row sub-block, padded to its maximal alignment (at least one byte)
+    uint64_t hot_stride = 0, hot_alignment = 8;
+    std::vector<uint64_t> offset(types.size());
+    for (auto& type : hot){
+        hot_alignment = std::max(hot_alignment, type.first->alignment());
+        hot_stride = align_up(hot_stride, type.first->alignment());
+        offset[type.second] = hot_stride;
+        hot_stride += type.first->size();
+    }
+    hot_stride = align_up(hot_stride, hot_alignment);
+
+    // computing how many tuples fit in one block: start from the exact estimate and shrink until all minipages,
+    // rounded up to their alignment, fit
+    const uint64_t block_stride = block_size_in_bytes_ * 8;
+    uint64_t tuple_size = hot_stride + types.size();
+    for (auto& type : cold)
+        tuple_size += type.first->size();
+    M_insist(tuple_size != 0, "a PAX block requires at least one attribute");
+
+    uint64_t tuples_per_block = block_stride / tuple_size;
+    std::vector<uint64_t> minipage_offset(types.size());
+    uint64_t bitmap_offset;
+    for (;; --tuples_per_block) {
+        uint64_t cur_offset = tuples_per_block * hot_stride;
+        for (auto& type : cold){
+            cur_offset = align_up(cur_offset, type.first->alignment());
+            minipage_offset[type.second] = cur_offset;
+            cur_offset += type.first->size() * tuples_per_block;
+        }
+        bitmap_offset = cur_offset;
+        if (bitmap_offset + types.size() * tuples_per_block <= block_stride)
+            break;
+    }
+    M_insist(tuples_per_block != 0, "a single tuple exceeds the block size");
+
+    DataLayout DL;
+    auto &block = DL.add_inode(tuples_per_block, block_stride);
+
+    // hot attributes: a sequence of narrow rows at the beginning of the block
+    if (not hot.empty()) {
+        auto &row = block.add_inode(1, 0, hot_stride);
+        std::sort(hot.begin(), hot.end(), [](auto a, auto b) { return a.second < b.second; });
+        for (auto& type : hot)
+            row.add_leaf(type.first, type.second, offset[type.second], 0);
+    }
+
+    // cold attributes: one minipage each
+    std::sort(cold.begin(), cold.end(), [](auto a, auto b) { return a.second < b.second; });
+    for (auto& type : cold)
+        block.add_leaf(type.first, type.second, minipage_offset[type.second], type.first->size());
+
     // Bitmap leaf
-    row.add_leaf(Type::Get_Bitmap(Type::TY_Vector, types.size()), types.size(), cur_offset, 1);
+    block.add_leaf(Type::Get_Bitmap(Type::TY_Vector, types.size()), types.size(), bitmap_offset, types.size());
 
     return DL;
 }
+
+attribute_path compute_attribute_path(const DataLayout &layout, std::size_t attr)
+{
+    auto inode = cast<const DataLayout::INode>(&layout.child());
+    M_insist(inode, "the root of a layout must be an INode");
+
+    attribute_path path;
+    path.levels.push_back({ inode->num_tuples(), 0, layout.stride_in_bits() });
+    for (;;) {
+        const DataLayout::INode *next = nullptr;
+        for (std::size_t i = 0; i != inode->num_children(); ++i) {
+            auto &child = inode->at(i);
+            if (auto leaf = cast<const DataLayout::Leaf>(child.ptr.get())) {
+                if (leaf->index() == attr) {
+                    path.levels.push_back({ 1, child.offset_in_bits, child.stride_in_bits });
+                    return path;
+                }
+            } else if (auto child_inode = cast<const DataLayout::INode>(child.ptr.get());
+                       contains_attribute(*child_inode, attr))
+            {
+                path.levels.push_back({ child_inode->num_tuples(), child.offset_in_bits, child.stride_in_bits });
+                next = child_inode;
+                break;
+            }
+        }
+        if (not next)
+            throw std::out_of_range("the layout does not contain attribute " + std::to_string(attr));
+        inode = next;
+    }
+}
+
+std::vector<double> compute_access_frequencies(const std::vector<const char*> &attributes, std::istream &queries)
+{
+    std::vector<std::size_t> num_accesses(attributes.size());
+    std::size_t num_statements = 0;
+
+    std::string stmt;
+    while (std::getline(queries, stmt, ';')) {
+        // splitting the statement into identifiers and punctuation, skipping string literals
+        std::vector<std::string> tokens;
+        std::string token;
+        char quote = 0;
+        for (char c : stmt + ' ') {
+            if (quote) {
+                quote = c == quote ? 0 : quote;
+                continue;
+            }
+            if (std::isalnum(static_cast<unsigned char>(c)) or c == '_') {
+                token += c;
+                continue;
+            }
+            if (not token.empty())
+                tokens.push_back(std::move(token));
+            token.clear();
+            if (c == '"' or c == '\'')
+                quote = c;
+            else if (not std::isspace(static_cast<unsigned char>(c)))
+                tokens.emplace_back(1, c);
+        }
+        if (tokens.empty())
+            continue; // empty statement, e.g. after the last `;`
+
+        // a `*` following `SELECT`, `,`, or `.` is a wildcard, otherwise a multiplication
+        bool selects_all = false;
+        for (std::size_t i = 1; i < tokens.size(); ++i) {
+            if (tokens[i] != "*")
+                continue;
+            std::string prev = tokens[i - 1];
+            std::transform(prev.begin(), prev.end(), prev.begin(), [](unsigned char c) { return std::toupper(c); });
+            selects_all = selects_all or prev == "SELECT" or prev == "," or prev == ".";
+        }
+
+        ++num_statements;
+        for (std::size_t idx = 0; idx != attributes.size(); ++idx) {
+            if (selects_all or std::find(tokens.begin(), tokens.end(), attributes[idx]) != tokens.end())
+                ++num_accesses[idx];
+        }
+    }
+
+    std::vector<double> frequencies(attributes.size(), 0.);
+    if (num_statements)
+        std::transform(num_accesses.begin(), num_accesses.end(), frequencies.begin(),
+                       [num_statements](std::size_t n) { return double(n) / num_statements; });
+    return frequencies;
+}
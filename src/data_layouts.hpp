@@ -1,21 +1,258 @@
 #pragma once
 
 
+#include <algorithm>
+#include <istream>
+#include <limits>
 #include <mutable/mutable.hpp>
 #include <mutable/storage/DataLayoutFactory.hpp>
+#include <utility>
+#include <vector>
 
 
+/** Row layouts place the NULL bitmap, one bit per attribute, in the first padding hole large enough, or behind the last
+ * attribute.  If the factory is created with `nullable = false`, all attributes are assumed to be NOT NULL and no NULL
+ * bitmap is stored at all. */
 struct MyNaiveRowLayoutFactory : m::storage::DataLayoutFactory
 {
+    private:
+    bool nullable_;
+
+    public:
+    explicit MyNaiveRowLayoutFactory(bool nullable = true) : nullable_(nullable) { }
+
     m::storage::DataLayout make(std::vector<const m::Type*> types, std::size_t num_tuples = 0) const override;
 };
 
 struct MyOptimizedRowLayoutFactory : m::storage::DataLayoutFactory
 {
+    private:
+    bool nullable_;
+
+    public:
+    explicit MyOptimizedRowLayoutFactory(bool nullable = true) : nullable_(nullable) { }
+
+    m::storage::DataLayout make(std::vector<const m::Type*> types, std::size_t num_tuples = 0) const override;
+};
+
+/** A row layout that places attributes such that the stride is minimal.  The placement is solved exactly for up to
+ * `EXACT_LIMIT` attributes and by sorting by alignment beyond.  Optionally, \p groups of attributes that are accessed
+ * together are placed first, each packed as tightly as possible and, if it fits, not crossing a cache line (64 bytes).
+ * Groups are placed in the given order.  With groups, rows are padded to a power of two of at most 64 bytes or to a
+ * multiple of 64 bytes, such that the groups of every row, not only of the first one, stay within their lines. */
+struct MyPackedRowLayoutFactory : m::storage::DataLayoutFactory
+{
+    static constexpr std::size_t EXACT_LIMIT = 20;
+    static constexpr uint64_t CACHE_LINE_IN_BITS = 64 * 8;
+
+    private:
+    std::vector<std::vector<std::size_t>> groups_;
+    bool nullable_;
+
+    public:
+    explicit MyPackedRowLayoutFactory(std::vector<std::vector<std::size_t>> groups = {}, bool nullable = true)
+        : groups_(std::move(groups))
+        , nullable_(nullable)
+    { }
+
+    m::storage::DataLayout make(std::vector<const m::Type*> types, std::size_t num_tuples = 0) const override;
+};
+
+/** A row layout for point accesses that keeps tuples from straddling cache lines (64 bytes).  Rows of at most 64 bytes
+ * get a power-of-two stride, such that every cache line holds a whole number of rows, and wider rows start at a cache
+ * line boundary.  If rows are wider than 64 bytes and \p hot attributes are given, the tuples are split into a hot and
+ * a cold part: every block holds a sub-block of rows of the hot attributes, again with a power-of-two stride, followed
+ * by a sub-block of rows of the cold attributes.  Then accessing the hot attributes of a tuple touches a single cache
+ * line, as long as they fit into one. */
+struct MyCacheAlignedRowLayoutFactory : m::storage::DataLayoutFactory
+{
+    static constexpr uint64_t CACHE_LINE_IN_BITS = 64 * 8;
+    ///> the number of tuples per block of a layout split into hot and cold rows
+    static constexpr std::size_t TUPLES_PER_BLOCK = 1024;
+
+    private:
+    std::vector<std::size_t> hot_;
+    bool nullable_;
+
+    public:
+    explicit MyCacheAlignedRowLayoutFactory(std::vector<std::size_t> hot = {}, bool nullable = true)
+        : hot_(std::move(hot))
+        , nullable_(nullable)
+    { }
+
+    m::storage::DataLayout make(std::vector<const m::Type*> types, std::size_t num_tuples = 0) const override;
+};
+
+/** A PAX layout with blocks of a configurable size. */
+struct MyPAXLayoutFactory : m::storage::DataLayoutFactory
+{
+    private:
+    std::size_t block_size_in_bytes_;
+
+    public:
+    explicit MyPAXLayoutFactory(std::size_t block_size_in_bytes) : block_size_in_bytes_(block_size_in_bytes) { }
+
+    std::size_t block_size_in_bytes() const { return block_size_in_bytes_; }
+
     m::storage::DataLayout make(std::vector<const m::Type*> types, std::size_t num_tuples = 0) const override;
+
+    protected:
+    /** Computes a PAX layout whose blocks start with a header of \p header_size_in_bits, followed by the minipages. */
+    m::storage::DataLayout make_blocks(std::vector<const m::Type*> types, uint64_t header_size_in_bits) const;
+};
+
+struct MyPAX4kLayoutFactory : MyPAXLayoutFactory
+{
+    MyPAX4kLayoutFactory() : MyPAXLayoutFactory(4096) { }
 };
 
-struct MyPAX4kLayoutFactory : m::storage::DataLayoutFactory
+/** A PAX layout whose blocks start with a header holding a synopsis, i.e. minimum, maximum, and number of NULL values,
+ * of every fixed-size numeric attribute, in the order of the attributes.  The synopses enable scans to skip blocks
+ * that cannot contain qualifying tuples.  mutable does not know about the header; see `ZoneMaps` for maintaining and
+ * using the synopses. */
+struct MyPAXZoneMapLayoutFactory : MyPAXLayoutFactory
 {
+    ///> a synopsis consists of 64 bit minimum, maximum, and NULL count
+    static constexpr uint64_t SYNOPSIS_SIZE_IN_BITS = 3 * 64;
+
+    explicit MyPAXZoneMapLayoutFactory(std::size_t block_size_in_bytes = 4096)
+        : MyPAXLayoutFactory(block_size_in_bytes)
+    { }
+
+    /** Returns `true` iff a synopsis is kept for attributes of type \p type, i.e. for integers, decimals of at most 64
+     * bits, floating-point numbers, and dates. */
+    static bool has_synopsis(const m::Type *type) {
+        return (type->is_numeric() and type->size() <= 64) or type->is_date();
+    }
+
     m::storage::DataLayout make(std::vector<const m::Type*> types, std::size_t num_tuples = 0) const override;
 };
+
+/** A PAX layout whose block size is derived from the cache hierarchy of the machine.  The L1d and L2 sizes are read
+ * from sysfs on construction.  A block is at most as large as L1d, such that the minipages of all attributes of a
+ * block fit in L1d during a scan, unless rows are so wide that a block would hold too few tuples.  Then the block is
+ * grown up to half of L2.  The block size is always within [4 KiB, 2 MiB]. */
+struct MyPAXAutoLayoutFactory : m::storage::DataLayoutFactory
+{
+    ///> the minimal number of tuples per block before growing blocks beyond L1d
+    static constexpr std::size_t MIN_TUPLES_PER_BLOCK = 64;
+    static constexpr std::size_t MIN_BLOCK_SIZE = 4096;
+    static constexpr std::size_t MAX_BLOCK_SIZE = 2 * 1024 * 1024;
+
+    private:
+    std::size_t L1d_size_in_bytes_;
+    std::size_t L2_size_in_bytes_;
+
+    public:
+    MyPAXAutoLayoutFactory();
+    MyPAXAutoLayoutFactory(std::size_t L1d_size_in_bytes, std::size_t L2_size_in_bytes)
+        : L1d_size_in_bytes_(L1d_size_in_bytes)
+        , L2_size_in_bytes_(L2_size_in_bytes)
+    { }
+
+    /** Returns the block size chosen for a table whose tuples take \p tuple_size_in_bits in a block. */
+    std::size_t block_size_in_bytes(uint64_t tuple_size_in_bits) const;
+
+    m::storage::DataLayout make(std::vector<const m::Type*> types, std::size_t num_tuples = 0) const override;
+};
+
+/** A decomposition storage model (DSM), i.e. a pure columnar layout.  Each attribute is stored in its own contiguous
+ * array and the NULL bitmaps are stored as a separate dense column.  Every array starts at a cache line (64 bytes)
+ * boundary.  A block holds the number of tuples hinted by `num_tuples`, rounded up to a multiple of 512 such that all
+ * arrays are multiples of 64 bytes, or `DEFAULT_TUPLES_PER_BLOCK` if no hint is given. */
+struct MyDSMLayoutFactory : m::storage::DataLayoutFactory
+{
+    static constexpr std::size_t ALIGNMENT_IN_BITS = 64 * 8;
+    static constexpr std::size_t DEFAULT_TUPLES_PER_BLOCK = 1 << 16;
+
+    m::storage::DataLayout make(std::vector<const m::Type*> types, std::size_t num_tuples = 0) const override;
+};
+
+/** A hybrid row/column layout driven by a workload.  Every block starts with a narrow row-packed sub-block holding the
+ * *hot* attributes, i.e. those whose access frequency reaches the threshold, followed by one PAX minipage per *cold*
+ * attribute and the NULL bitmap.  Attributes without a given frequency are considered cold. */
+struct MyHybridLayoutFactory : m::storage::DataLayoutFactory
+{
+    private:
+    std::vector<double> access_frequencies_;
+    double hot_threshold_;
+    std::size_t block_size_in_bytes_;
+
+    public:
+    MyHybridLayoutFactory(std::vector<double> access_frequencies, double hot_threshold = .5,
+                          std::size_t block_size_in_bytes = 4096)
+        : access_frequencies_(std::move(access_frequencies))
+        , hot_threshold_(hot_threshold)
+        , block_size_in_bytes_(block_size_in_bytes)
+    { }
+
+    bool is_hot(std::size_t idx) const {
+        return idx < access_frequencies_.size() and access_frequencies_[idx] >= hot_threshold_;
+    }
+
+    m::storage::DataLayout make(std::vector<const m::Type*> types, std::size_t num_tuples = 0) const override;
+};
+
+/** The path from the root of a layout to the leaf of one attribute.  Every level, from the root to the leaf, stores
+ * its tuples in instances of `num_tuples` tuples each, `stride_in_bits` apart, beginning at `offset_in_bits` within the
+ * enclosing instance.  Leaves hold a single tuple per instance. */
+struct attribute_path
+{
+    struct level
+    {
+        std::size_t num_tuples;
+        uint64_t offset_in_bits;
+        uint64_t stride_in_bits;
+    };
+
+    std::vector<level> levels;
+
+    /** Returns the offset in bits of the value of tuple \p row, relative to the beginning of the memory of a store. */
+    uint64_t offset_in_bits(std::size_t row) const {
+        uint64_t offset = 0;
+        for (auto &l : levels) {
+            offset += l.offset_in_bits + (row / l.num_tuples) * l.stride_in_bits;
+            row %= l.num_tuples;
+        }
+        return offset;
+    }
+
+    /** Returns the distance in bits between the values of consecutive tuples of the same instance, i.e. the stride of
+     * the outermost level that holds a single tuple per instance. */
+    uint64_t tuple_stride_in_bits() const {
+        for (auto &l : levels) {
+            if (l.num_tuples == 1)
+                return l.stride_in_bits;
+        }
+        return levels.back().stride_in_bits;
+    }
+
+    /** Returns the number of tuples, beginning at tuple \p row, whose values lie `tuple_stride_in_bits()` apart, i.e.
+     * up to the end of the innermost instance with multiple tuples that holds tuple \p row. */
+    std::size_t num_strided_rows(std::size_t row) const {
+        std::size_t n = std::numeric_limits<std::size_t>::max();
+        for (auto &l : levels) {
+            if (l.num_tuples == 1)
+                break;
+            n = std::min(n, l.num_tuples - row % l.num_tuples);
+            row %= l.num_tuples;
+        }
+        return n;
+    }
+};
+
+/** Computes the path to attribute \p attr in \p layout.  The index of the NULL bitmap is the number of attributes.
+ * Throws `std::out_of_range` if \p layout has no leaf for \p attr. */
+attribute_path compute_attribute_path(const m::storage::DataLayout &layout, std::size_t attr);
+
+/** Returns the offset in bits of attribute \p attr of tuple \p row, relative to the beginning of the memory of a store
+ * with \p layout.  The index of the NULL bitmap is the number of attributes. */
+inline uint64_t attribute_offset_in_bits(const m::storage::DataLayout &layout, std::size_t row, std::size_t attr)
+{
+    return compute_attribute_path(layout, attr).offset_in_bits(row);
+}
+
+/** Computes for each of the given \p attributes the fraction of statements in \p queries that access it.  Statements
+ * are separated by `;`.  An attribute is accessed if its name occurs as an identifier in the statement or if the
+ * statement selects `*`. */
+std::vector<double> compute_access_frequencies(const std::vector<const char*> &attributes, std::istream &queries);
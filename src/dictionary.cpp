@@ -0,0 +1,152 @@
+#include "dictionary.hpp"
+#include "csv.hpp"
+#include <cctype>
+
+
+using namespace m;
+
+
+Dictionary::code_type Dictionary::encode(const std::string &value)
+{
+    auto [it, inserted] = codes_.try_emplace(value, code_type(values_.size()));
+    if (inserted)
+        values_.push_back(value);
+    return it->second;
+}
+
+Dictionary::code_type Dictionary::find(const std::string &value) const
+{
+    auto it = codes_.find(value);
+    return it == codes_.end() ? NOT_FOUND : it->second;
+}
+
+const Type * Dictionary::code_type_for() const
+{
+    if (size() <= 1UL << 7)
+        return Type::Get_Integer(Type::TY_Vector, 1);
+    if (size() <= 1UL << 15)
+        return Type::Get_Integer(Type::TY_Vector, 2);
+    return Type::Get_Integer(Type::TY_Vector, 4);
+}
+
+std::vector<Dictionary> dictionary_encode_CSV(std::istream &in, std::ostream &out,
+                                              const std::vector<std::size_t> &columns,
+                                              const std::vector<std::size_t> &max_lengths,
+                                              bool has_header)
+{
+    std::vector<Dictionary> dicts(columns.size());
+    std::vector<std::string> fields;
+
+    if (has_header and read_CSV_record(in, fields))
+        write_CSV_record(out, fields);
+
+    while (read_CSV_record(in, fields)) {
+        for (std::size_t i = 0; i != columns.size(); ++i) {
+            if (columns[i] >= fields.size() or fields[columns[i]].empty())
+                continue; // missing values remain NULL
+            auto &field = fields[columns[i]];
+            field = std::to_string(dicts[i].encode(field.substr(0, max_lengths[i])));
+        }
+        write_CSV_record(out, fields);
+    }
+
+    return dicts;
+}
+
+void write_dictionary_CSV(std::ostream &out, const Dictionary &dict)
+{
+    write_CSV_record(out, { "code", "value" });
+    for (std::size_t code = 0; code != dict.size(); ++code)
+        write_CSV_record(out, { std::to_string(code), dict.decode(code) });
+}
+
+namespace {
+
+enum token_kind { TK_Other, TK_Space, TK_Identifier, TK_String };
+
+struct token
+{
+    token_kind kind;
+    std::string text;
+};
+
+std::vector<token> tokenize(const std::string &sql)
+{
+    std::vector<token> tokens;
+    for (std::size_t pos = 0; pos < sql.size(); ) {
+        const unsigned char c = sql[pos];
+        std::size_t end = pos + 1;
+        token_kind kind = TK_Other;
+        if (std::isspace(c)) {
+            while (end < sql.size() and std::isspace(static_cast<unsigned char>(sql[end]))) ++end;
+            kind = TK_Space;
+        } else if (std::isalpha(c) or c == '_') {
+            while (end < sql.size() and (std::isalnum(static_cast<unsigned char>(sql[end])) or sql[end] == '_')) ++end;
+            kind = TK_Identifier;
+        } else if (c == '"' or c == '\'') {
+            while (end < sql.size() and sql[end] != c) ++end;
+            end = std::min(end + 1, sql.size());
+            kind = TK_String;
+        } else if (sql.compare(pos, 2, "!=") == 0 or sql.compare(pos, 2, "<>") == 0 or
+                   sql.compare(pos, 2, "<=") == 0 or sql.compare(pos, 2, ">=") == 0) {
+            end = pos + 2;
+        }
+        tokens.push_back({ kind, sql.substr(pos, end - pos) });
+        pos = end;
+    }
+    return tokens;
+}
+
+}
+
+std::string rewrite_dictionary_predicates(const std::string &sql,
+                                          const std::unordered_map<std::string, const Dictionary*> &attributes)
+{
+    auto tokens = tokenize(sql);
+
+    /* Returns the index of the next token after `i` that is not white space, or `tokens.size()`. */
+    auto next = [&](std::size_t i) {
+        do ++i; while (i < tokens.size() and tokens[i].kind == TK_Space);
+        return i;
+    };
+    auto is_equality = [&](std::size_t i) {
+        return i < tokens.size() and (tokens[i].text == "=" or tokens[i].text == "!=" or tokens[i].text == "<>");
+    };
+    auto is_string = [&](std::size_t i) { return i < tokens.size() and tokens[i].kind == TK_String; };
+    /* Returns the dictionary of the possibly qualified attribute starting at token `i`, and the index of its last
+     * token. */
+    auto attribute_at = [&](std::size_t i) -> std::pair<const Dictionary*, std::size_t> {
+        if (i >= tokens.size() or tokens[i].kind != TK_Identifier)
+            return { nullptr, i };
+        if (i + 2 < tokens.size() and tokens[i + 1].text == "." and tokens[i + 2].kind == TK_Identifier)
+            i += 2;
+        auto it = attributes.find(tokens[i].text);
+        return { it == attributes.end() ? nullptr : it->second, i };
+    };
+    auto encode = [](token &literal, const Dictionary &dict) {
+        const std::string value = literal.text.substr(1, literal.text.size() - 2);
+        literal = { TK_Other, std::to_string(dict.find(value)) };
+    };
+
+    for (std::size_t i = 0; i < tokens.size(); ++i) {
+        if (auto [dict, last] = attribute_at(i); dict) {
+            /* attr = "value" */
+            const std::size_t op = next(last), literal = next(op);
+            if (is_equality(op) and is_string(literal))
+                encode(tokens[literal], *dict);
+            i = last;
+        } else if (is_string(i)) {
+            /* "value" = attr */
+            const std::size_t op = next(i);
+            if (not is_equality(op))
+                continue;
+            if (auto [dict, last] = attribute_at(next(op)); dict)
+                encode(tokens[i], *dict);
+        }
+    }
+
+    std::string result;
+    for (auto &tok : tokens)
+        result += tok.text;
+    return result;
+}
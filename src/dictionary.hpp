@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstdint>
+#include <istream>
+#include <mutable/mutable.hpp>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+
+/** A dictionary mapping the distinct values of an attribute to dense integer codes, assigned in order of first
+ * occurrence.  Storing the codes instead of the values shrinks low-cardinality `CHAR(n)` attributes to a few bytes
+ * and turns equality predicates into integer comparisons. */
+struct Dictionary
+{
+    using code_type = int32_t;
+
+    ///> the code of values not contained in the dictionary; it never matches a stored code
+    static constexpr code_type NOT_FOUND = -1;
+
+    private:
+    std::vector<std::string> values_;
+    std::unordered_map<std::string, code_type> codes_;
+
+    public:
+    /** Returns the code of \p value, inserting \p value into the dictionary if necessary. */
+    code_type encode(const std::string &value);
+    /** Returns the code of \p value, or `NOT_FOUND` if \p value is not contained in the dictionary. */
+    code_type find(const std::string &value) const;
+    /** Returns the value of \p code. */
+    const std::string & decode(code_type code) const { return values_.at(code); }
+
+    std::size_t size() const { return values_.size(); }
+
+    /** Returns the smallest integer type that can represent all codes. */
+    const m::Type * code_type_for() const;
+};
+
+/** Dictionary-encodes the \p columns of the CSV file \p in and writes the encoded file to \p out.  Values are truncated
+ * to the respective \p max_lengths before encoding, like a `CHAR(n)` attribute would.  If \p has_header, the first
+ * record is copied verbatim.  Returns one dictionary per encoded column. */
+std::vector<Dictionary> dictionary_encode_CSV(std::istream &in, std::ostream &out,
+                                              const std::vector<std::size_t> &columns,
+                                              const std::vector<std::size_t> &max_lengths,
+                                              bool has_header = true);
+
+/** Writes the dictionary \p dict as CSV file with header `code,value` to \p out. */
+void write_dictionary_CSV(std::ostream &out, const Dictionary &dict);
+
+/** Rewrites equality predicates between a dictionary-encoded attribute and a string literal in \p sql, i.e.
+ * `attr = "value"`, `attr != "value"`, and `attr <> "value"` (with either operand first), into comparisons with the
+ * code of the literal.  \p attributes maps the names of encoded attributes to their dictionaries. */
+std::string rewrite_dictionary_predicates(const std::string &sql,
+                                          const std::unordered_map<std::string, const Dictionary*> &attributes);
@@ -0,0 +1,236 @@
+#include "csv.hpp"
+#include "data_layouts.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <mutable/mutable.hpp>
+#include <set>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+
+/** The number of times every query is executed; the fastest execution counts. */
+constexpr unsigned NUM_REPETITIONS = 3;
+/** The number of tuples loaded per table by default. */
+constexpr std::size_t DEFAULT_SAMPLE_SIZE = 10000;
+
+namespace {
+
+/** A table to give advice for: its name, its attributes, and the CSV file holding its data. */
+struct table_spec
+{
+    const char *name;
+    std::vector<std::pair<const char*, const m::Type*>> attributes;
+    const char *csv_file;
+};
+
+/** A candidate layout. */
+struct candidate
+{
+    std::string name;
+    std::unique_ptr<m::storage::DataLayoutFactory> factory;
+};
+
+/** Splits \p sql into statements separated by `;`, ignoring `;` within string literals.  Every statement keeps its
+ * terminating `;`. */
+std::vector<std::string> split_statements(const std::string &sql)
+{
+    std::vector<std::string> statements;
+    std::string current;
+    char quote = 0;
+    for (char c : sql) {
+        current += c;
+        if (quote) {
+            if (c == quote)
+                quote = 0;
+        } else if (c == '"' or c == '\'') {
+            quote = c;
+        } else if (c == ';') {
+            if (current.find_first_not_of(" \t\r\n;") != std::string::npos)
+                statements.push_back(std::move(current));
+            current.clear();
+        }
+    }
+    return statements;
+}
+
+/** Returns the number of records of the CSV file \p filename, excluding the header. */
+std::size_t count_CSV_records(const char *filename)
+{
+    std::ifstream in(filename);
+    std::vector<std::string> fields;
+    std::size_t num_records = 0;
+    while (read_CSV_record(in, fields))
+        ++num_records;
+    return num_records ? num_records - 1 : 0;
+}
+
+/** Returns the candidate layouts for \p table, i.e. all layouts `milestone1` offers plus hybrid layouts for every hot
+ * set the \p queries induce. */
+std::vector<candidate> make_candidates(const table_spec &table, const std::string &queries)
+{
+    std::vector<candidate> candidates;
+    auto add = [&candidates](std::string name, std::unique_ptr<m::storage::DataLayoutFactory> factory) {
+        candidates.push_back({ std::move(name), std::move(factory) });
+    };
+    add("row_naive", std::make_unique<MyNaiveRowLayoutFactory>());
+    add("row_optimized", std::make_unique<MyOptimizedRowLayoutFactory>());
+    add("row_packed", std::make_unique<MyPackedRowLayoutFactory>());
+    add("PAX4k", std::make_unique<MyPAX4kLayoutFactory>());
+    add("PAX16k", std::make_unique<MyPAXLayoutFactory>(16 * 1024));
+    add("PAX64k", std::make_unique<MyPAXLayoutFactory>(64 * 1024));
+    add("PAX256k", std::make_unique<MyPAXLayoutFactory>(256 * 1024));
+    add("PAX2M", std::make_unique<MyPAXLayoutFactory>(2 * 1024 * 1024));
+    add("PAXauto", std::make_unique<MyPAXAutoLayoutFactory>());
+    add("DSM", std::make_unique<MyDSMLayoutFactory>());
+
+    /* Every distinct access frequency is a threshold that separates a different set of hot attributes. */
+    std::vector<const char*> names;
+    for (auto &attr : table.attributes)
+        names.push_back(attr.first);
+    std::istringstream in(queries);
+    const auto frequencies = compute_access_frequencies(names, in);
+    std::vector<std::size_t> hot;
+    for (std::size_t idx = 0; idx != frequencies.size(); ++idx) {
+        if (frequencies[idx] >= .5)
+            hot.push_back(idx);
+    }
+    add("row_cache_aligned", std::make_unique<MyCacheAlignedRowLayoutFactory>(std::move(hot)));
+
+    const std::set<double> thresholds(frequencies.begin(), frequencies.end());
+    for (double threshold : thresholds) {
+        if (threshold == 0)
+            continue; // every attribute would be hot
+        std::ostringstream name;
+        name << "hybrid@" << threshold;
+        add(name.str(), std::make_unique<MyHybridLayoutFactory>(frequencies, threshold));
+    }
+
+    return candidates;
+}
+
+}
+
+int main(int argc, const char **argv)
+{
+    /* Check the number of parameters. */
+    if (argc != 3 and argc != 4) {
+        std::cerr << "Usage: " << argv[0] << " <CSV-File> <SQL-File> [<Sample-Size>]\n"
+                  << "  Recommends a data layout per table for the queries in the SQL file, by executing them on a\n"
+                  << "  sample of the first <Sample-Size> tuples (default " << DEFAULT_SAMPLE_SIZE << ")."
+                  << std::endl;
+        exit(EXIT_FAILURE);
+    }
+    const std::size_t sample_size = argc == 4 ? std::strtoul(argv[3], nullptr, 10) : DEFAULT_SAMPLE_SIZE;
+    if (sample_size == 0) {
+        std::cerr << "Sample-Size must be positive" << std::endl;
+        exit(EXIT_FAILURE);
+    }
+
+    std::string sql;
+    {
+        std::ifstream in(argv[2]);
+        if (not in) {
+            std::cerr << "Could not open " << argv[2] << std::endl;
+            exit(EXIT_FAILURE);
+        }
+        sql.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+    const auto statements = split_statements(sql);
+
+    const std::vector<table_spec> tables = {
+        { "packages", {
+            { "id",          m::Type::Get_Integer(m::Type::TY_Vector, 4) },
+            { "repo",        m::Type::Get_Char(m::Type::TY_Vector, 10) },
+            { "pkg_name",    m::Type::Get_Char(m::Type::TY_Vector, 32) },
+            { "pkg_ver",     m::Type::Get_Char(m::Type::TY_Vector, 20) },
+            { "description", m::Type::Get_Char(m::Type::TY_Vector, 80) },
+            { "licenses",    m::Type::Get_Char(m::Type::TY_Vector, 32) },
+            { "size",        m::Type::Get_Integer(m::Type::TY_Vector, 8) },
+            { "packager",    m::Type::Get_Char(m::Type::TY_Vector, 32) },
+        }, argv[1] },
+    };
+
+    /* Create a `m::Diagnostic` object. */
+    m::Diagnostic diag(true, std::cout, std::cerr);
+
+    std::cout << "table,layout,sample_ms,predicted_ms,stride_in_bits\n";
+    for (auto &table : tables) {
+        const std::size_t num_records = count_CSV_records(table.csv_file);
+        const std::size_t num_sampled = std::min(sample_size, num_records);
+        const double scale = num_sampled ? double(num_records) / num_sampled : 0;
+
+        std::string best;
+        double best_cost = std::numeric_limits<double>::infinity();
+        uint64_t best_stride = 0;
+
+        for (auto &[name, factory] : make_candidates(table, sql)) {
+            /* Start over with an empty database for every candidate. */
+            m::Catalog::Clear();
+            auto &C = m::Catalog::Get();
+            auto &DB = C.add_database(C.pool("advisor"));
+            C.set_database_in_use(DB);
+
+            /* Create the table and load the sample. */
+            auto &T = DB.add_table(C.pool(table.name));
+            for (auto &[attr, type] : table.attributes)
+                T.push_back(C.pool(attr), type);
+            T.store(C.create_store(T));
+            T.layout(factory->make(T.schema(), num_sampled));
+            m::load_from_CSV(diag, T, table.csv_file, num_sampled, true, false);
+            if (diag.num_errors())
+                exit(EXIT_FAILURE);
+
+            /* Execute every query and sum up the fastest execution times. */
+            using namespace std::chrono;
+            duration<double, std::milli> cost(0);
+            for (auto &statement : statements) {
+                auto stmt = m::statement_from_string(diag, statement);
+                if (diag.num_errors())
+                    exit(EXIT_FAILURE);
+                auto query = m::cast<m::ast::SelectStmt>(stmt.get());
+                if (not query)
+                    continue; // only queries are benchmarked
+
+                auto fastest = duration<double, std::milli>::max();
+                for (unsigned r = 0; r != NUM_REPETITIONS; ++r) {
+                    std::size_t num_results = 0;
+                    auto op = std::make_unique<m::CallbackOperator>([&num_results](const m::Schema&, const m::Tuple&) {
+                        ++num_results;
+                    });
+                    auto begin = steady_clock::now();
+                    m::execute_query(diag, *query, std::move(op));
+                    fastest = std::min<duration<double, std::milli>>(fastest, steady_clock::now() - begin);
+                }
+                cost += fastest;
+            }
+
+            /* The scan cost grows linearly with the number of tuples. */
+            const double predicted = cost.count() * scale;
+            auto &layout = T.layout();
+            const uint64_t stride = layout.stride_in_bits() / layout.child().num_tuples();
+            std::cout << table.name << ',' << name << ',' << cost.count() << ',' << predicted << ',' << stride
+                      << std::endl;
+
+            if (predicted < best_cost) {
+                best = name;
+                best_cost = predicted;
+                best_stride = stride;
+            }
+        }
+
+        std::cout << "Recommended layout for table '" << table.name << "': " << best << " (predicted scan cost "
+                  << best_cost << " ms for " << num_records << " tuples, " << best_stride << " bits per tuple)"
+                  << std::endl;
+    }
+
+    m::Catalog::Destroy();
+    exit(EXIT_SUCCESS);
+}
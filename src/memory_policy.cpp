@@ -0,0 +1,108 @@
+#include "memory_policy.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+
+namespace {
+
+#ifdef __linux__
+/* Constants of `mbind(2)`, which are declared in `numaif.h` of libnuma.  We issue the system call directly to not
+ * depend on libnuma. */
+constexpr int MPOL_BIND_ = 2;
+constexpr int MPOL_INTERLEAVE_ = 3;
+#endif
+
+}
+
+MemoryPolicy MemoryPolicy::Parse(const std::string &str)
+{
+    MemoryPolicy policy;
+    std::size_t begin = 0;
+    while (begin <= str.size()) {
+        std::size_t end = str.find(',', begin);
+        if (end == std::string::npos)
+            end = str.size();
+        const std::string flag = str.substr(begin, end - begin);
+
+        if (flag == "huge") {
+            policy.huge_pages = true;
+        } else if (flag == "interleave") {
+            policy.numa = NUMA_INTERLEAVE;
+        } else if (flag.starts_with("bind=") and flag.size() > 5 and
+                   flag.find_first_not_of("0123456789", 5) == std::string::npos) {
+            policy.numa = NUMA_BIND;
+            policy.node = std::stoul(flag.substr(5));
+        } else if (not flag.empty() or not str.empty()) {
+            throw std::invalid_argument("invalid memory policy '" + str + "'");
+        }
+        begin = end + 1;
+    }
+    return policy;
+}
+
+std::size_t num_numa_nodes()
+{
+    /* The file lists the online nodes as ranges, e.g. `0-1` or `0,2-3`. */
+    std::ifstream in("/sys/devices/system/node/online");
+    std::size_t num_nodes = 0;
+    std::string range;
+    while (std::getline(in, range, ',')) {
+        const auto dash = range.find('-');
+        if (dash == std::string::npos)
+            ++num_nodes;
+        else
+            num_nodes += std::stoul(range.substr(dash + 1)) - std::stoul(range.substr(0, dash)) + 1;
+    }
+    return std::max<std::size_t>(num_nodes, 1);
+}
+
+bool apply_memory_policy(void *addr, std::size_t size, const MemoryPolicy &policy)
+{
+#ifdef __linux__
+    /* Both `madvise(2)` and `mbind(2)` operate on whole pages. */
+    const uintptr_t page_size = sysconf(_SC_PAGESIZE);
+    const uintptr_t begin = (reinterpret_cast<uintptr_t>(addr) + page_size - 1) & ~(page_size - 1);
+    const uintptr_t end = (reinterpret_cast<uintptr_t>(addr) + size) & ~(page_size - 1);
+    if (end <= begin)
+        return policy.is_default();
+    void *aligned_addr = reinterpret_cast<void*>(begin);
+
+    bool success = true;
+    if (policy.huge_pages)
+        success &= madvise(aligned_addr, end - begin, MADV_HUGEPAGE) == 0;
+
+    const std::size_t num_nodes = num_numa_nodes();
+    if (policy.numa != MemoryPolicy::NUMA_DEFAULT) {
+        if (policy.numa == MemoryPolicy::NUMA_BIND and policy.node >= num_nodes)
+            return false;
+        if (num_nodes > 1 or policy.numa == MemoryPolicy::NUMA_BIND) {
+            constexpr std::size_t BITS_PER_WORD = 8 * sizeof(unsigned long);
+            std::vector<unsigned long> nodemask((num_nodes + BITS_PER_WORD - 1) / BITS_PER_WORD);
+            if (policy.numa == MemoryPolicy::NUMA_BIND) {
+                nodemask[policy.node / BITS_PER_WORD] |= 1UL << (policy.node % BITS_PER_WORD);
+            } else {
+                for (std::size_t node = 0; node != num_nodes; ++node)
+                    nodemask[node / BITS_PER_WORD] |= 1UL << (node % BITS_PER_WORD);
+            }
+            const int mode = policy.numa == MemoryPolicy::NUMA_BIND ? MPOL_BIND_ : MPOL_INTERLEAVE_;
+            /* The kernel expects the number of bits of the mask plus one. */
+            success &= syscall(SYS_mbind, aligned_addr, end - begin, mode, nodemask.data(),
+                               nodemask.size() * BITS_PER_WORD + 1, 0) == 0;
+        }
+    }
+    return success;
+#else
+    (void) addr;
+    (void) size;
+    return policy.is_default();
+#endif
+}
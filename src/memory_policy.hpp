@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstddef>
+#include <mutable/mutable.hpp>
+#include <string>
+
+
+/** Describes how the memory backing a store is placed: optionally backed by 2 MiB transparent huge pages, and on hosts
+ * with multiple NUMA nodes either interleaved across all nodes or bound to a single node.  A policy only affects pages
+ * touched after it was applied, hence it must be applied right after the store is created, before appending tuples. */
+struct MemoryPolicy
+{
+    enum numa_t { NUMA_DEFAULT, NUMA_INTERLEAVE, NUMA_BIND };
+
+    bool huge_pages = false;
+    numa_t numa = NUMA_DEFAULT;
+    unsigned node = 0; ///< the node to bind to, if `numa` is `NUMA_BIND`
+
+    /** Parses a comma-separated list of `huge`, `interleave`, and `bind=<node>`, e.g. `huge,interleave`.  Throws
+     * `std::invalid_argument` on malformed input. */
+    static MemoryPolicy Parse(const std::string &str);
+
+    bool is_default() const { return not huge_pages and numa == NUMA_DEFAULT; }
+};
+
+/** Returns the number of NUMA nodes of this host, i.e. 1 if the host is not a NUMA system. */
+std::size_t num_numa_nodes();
+
+/** Applies \p policy to the \p size bytes of memory starting at \p addr.  Returns `false` if the operating system
+ * rejected any part of the policy, e.g. because transparent huge pages are disabled. */
+bool apply_memory_policy(void *addr, std::size_t size, const MemoryPolicy &policy);
+
+/** Applies \p policy to the memory backing \p store. */
+inline bool apply_memory_policy(const m::Store &store, const MemoryPolicy &policy)
+{
+    return apply_memory_policy(store.memory().addr(), store.memory().size(), policy);
+}
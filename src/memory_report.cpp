@@ -0,0 +1,160 @@
+#include "memory_report.hpp"
+#include <algorithm>
+#include <iomanip>
+
+
+using namespace m;
+using namespace m::storage;
+
+
+namespace {
+
+/** Accounts the \p count instances per block of \p inode in \p footprint.  Returns the number of bits of an instance
+ * that are used by its children, i.e. the end of the last child. */
+uint64_t account(layout_footprint &footprint, const DataLayout::INode &inode, std::size_t count, bool is_block)
+{
+    struct extent
+    {
+        const DataLayout::INode::child_t *child;
+        uint64_t begin;
+        uint64_t end;
+    };
+    std::vector<extent> extents;
+    for (auto &child : inode) {
+        const std::size_t repetitions = inode.num_tuples() / child.ptr->num_tuples();
+        uint64_t end;
+        if (auto leaf = cast<const DataLayout::Leaf>(child.ptr.get())) {
+            const uint64_t size = leaf->type()->size();
+            auto &attr = footprint.attributes[leaf->index()];
+            attr.payload_in_bits += size * repetitions * count;
+            if (repetitions > 1)
+                attr.padding_in_bits += (child.stride_in_bits - size) * (repetitions - 1) * count;
+            end = child.offset_in_bits + (repetitions - 1) * child.stride_in_bits + size;
+        } else {
+            auto &child_inode = as<const DataLayout::INode>(*child.ptr);
+            const uint64_t used = account(footprint, child_inode, count * repetitions, false);
+            if (repetitions > 1) {
+                footprint.tuple_padding_in_bits += (child.stride_in_bits - used) * repetitions * count;
+                end = child.offset_in_bits + repetitions * child.stride_in_bits;
+            } else {
+                end = child.offset_in_bits + used;
+            }
+        }
+        extents.push_back({ &child, child.offset_in_bits, end });
+    }
+
+    /* Padding in front of a value is accounted to its attribute, padding in front of a nested INode to the tuple.  The
+     * bits in front of the first child of a block are its header. */
+    std::sort(extents.begin(), extents.end(), [](auto &a, auto &b) { return a.begin < b.begin; });
+    uint64_t used = 0;
+    for (auto &e : extents) {
+        if (e.begin > used) {
+            const uint64_t gap = (e.begin - used) * count;
+            if (is_block and used == 0)
+                footprint.header_in_bits += gap;
+            else if (auto leaf = cast<const DataLayout::Leaf>(e.child->ptr.get()))
+                footprint.attributes[leaf->index()].padding_in_bits += gap;
+            else
+                footprint.tuple_padding_in_bits += gap;
+        }
+        used = std::max(used, e.end);
+    }
+    return used;
+}
+
+void print_line(std::ostream &out, const std::string &component, double payload_per_tuple, double padding_per_tuple,
+                uint64_t total_bytes)
+{
+    out << "  " << std::left << std::setw(20) << component << std::right
+        << std::setw(10) << payload_per_tuple << std::setw(10) << padding_per_tuple
+        << std::setw(16) << total_bytes << '\n';
+}
+
+}
+
+uint64_t layout_footprint::payload_in_bits() const
+{
+    uint64_t bits = 0;
+    for (std::size_t i = 0; i + 1 < attributes.size(); ++i)
+        bits += attributes[i].payload_in_bits;
+    return bits;
+}
+
+uint64_t layout_footprint::padding_in_bits() const
+{
+    uint64_t bits = tuple_padding_in_bits;
+    for (std::size_t i = 0; i + 1 < attributes.size(); ++i)
+        bits += attributes[i].padding_in_bits;
+    return bits;
+}
+
+layout_footprint compute_footprint(const Schema &schema, const DataLayout &layout)
+{
+    auto root = cast<const DataLayout::INode>(&layout.child());
+    M_insist(root, "the root of a layout must be an INode");
+
+    layout_footprint footprint;
+    footprint.tuples_per_block = root->num_tuples();
+    footprint.block_size_in_bits = layout.stride_in_bits();
+    footprint.attributes.resize(schema.num_entries() + 1);
+
+    const uint64_t used = account(footprint, *root, 1, footprint.tuples_per_block > 1);
+    const uint64_t rest = footprint.block_size_in_bits - std::min(used, footprint.block_size_in_bits);
+    if (footprint.tuples_per_block > 1)
+        footprint.unused_tail_in_bits = rest;
+    else
+        footprint.tuple_padding_in_bits += rest;
+    return footprint;
+}
+
+void print_footprint(std::ostream &out, const Schema &schema, const layout_footprint &footprint, std::size_t num_rows,
+                     std::size_t allocated_bytes)
+{
+    const std::size_t num_blocks = (num_rows + footprint.tuples_per_block - 1) / footprint.tuples_per_block;
+    const double bytes_per_tuple = 1. / (8 * footprint.tuples_per_block);
+    auto total = [num_blocks](uint64_t bits_per_block) { return num_blocks * bits_per_block / 8; };
+
+    const auto flags = out.flags();
+    const auto precision = out.precision();
+    out << std::fixed << std::setprecision(3);
+    out << footprint.tuples_per_block << " tuples in blocks of " << footprint.block_size_in_bits / 8 << " bytes, "
+        << num_blocks << " blocks for " << num_rows << " tuples\n";
+    out << "  " << std::left << std::setw(20) << "component" << std::right << std::setw(10) << "payload"
+        << std::setw(10) << "padding" << std::setw(16) << "total bytes" << "  (payload and padding in bytes/tuple)\n";
+
+    for (std::size_t i = 0; i != schema.num_entries(); ++i) {
+        auto &attr = footprint.attributes[i];
+        print_line(out, schema[i].id.name, attr.payload_in_bits * bytes_per_tuple,
+                   attr.padding_in_bits * bytes_per_tuple, total(attr.payload_in_bits + attr.padding_in_bits));
+    }
+    auto &bitmap = footprint.null_bitmap();
+    print_line(out, "NULL bitmap", bitmap.payload_in_bits * bytes_per_tuple, bitmap.padding_in_bits * bytes_per_tuple,
+               total(bitmap.payload_in_bits + bitmap.padding_in_bits));
+    print_line(out, "padding", 0, footprint.tuple_padding_in_bits * bytes_per_tuple,
+               total(footprint.tuple_padding_in_bits));
+    print_line(out, "header", 0, footprint.header_in_bits * bytes_per_tuple, total(footprint.header_in_bits));
+    print_line(out, "unused tail", 0, footprint.unused_tail_in_bits * bytes_per_tuple,
+               total(footprint.unused_tail_in_bits));
+
+    const uint64_t used_bytes = total(footprint.block_size_in_bits);
+    out << "  " << used_bytes << " bytes in blocks, of which " << total(footprint.payload_in_bits())
+        << " bytes payload; " << allocated_bytes << " bytes allocated, of which "
+        << (allocated_bytes - std::min<uint64_t>(allocated_bytes, used_bytes)) << " bytes unused\n";
+    out.flags(flags);
+    out.precision(precision);
+}
+
+void print_footprint_csv(std::ostream &out, const std::string &prefix, const Schema &schema,
+                         const layout_footprint &footprint)
+{
+    auto line = [&](const std::string &component, uint64_t payload_in_bits, uint64_t padding_in_bits) {
+        out << prefix << ',' << component << ',' << payload_in_bits << ',' << padding_in_bits << ','
+            << double(payload_in_bits + padding_in_bits) / (8 * footprint.tuples_per_block) << '\n';
+    };
+    for (std::size_t i = 0; i != schema.num_entries(); ++i)
+        line(schema[i].id.name, footprint.attributes[i].payload_in_bits, footprint.attributes[i].padding_in_bits);
+    line("NULL bitmap", footprint.null_bitmap().payload_in_bits, footprint.null_bitmap().padding_in_bits);
+    line("padding", 0, footprint.tuple_padding_in_bits);
+    line("header", 0, footprint.header_in_bits);
+    line("unused tail", 0, footprint.unused_tail_in_bits);
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <mutable/mutable.hpp>
+#include <ostream>
+#include <string>
+#include <vector>
+
+
+/** Where the bits of a block of a layout go.  A block is one instance of the root of the layout; row layouts have
+ * blocks of a single tuple.  All sizes are in bits per block and add up to the block's stride. */
+struct layout_footprint
+{
+    struct attribute
+    {
+        uint64_t payload_in_bits = 0; ///< the values
+        uint64_t padding_in_bits = 0; ///< the alignment padding in front of and between the values
+    };
+
+    std::size_t tuples_per_block = 0;
+    uint64_t block_size_in_bits = 0;
+    /** Per attribute, in the order of the schema, followed by the NULL bitmap. */
+    std::vector<attribute> attributes;
+    /** The padding that does not precede a value, i.e. behind the last value of a row and around nested INodes. */
+    uint64_t tuple_padding_in_bits = 0;
+    uint64_t header_in_bits = 0; ///< the bits in front of the first value of a block with multiple tuples
+    uint64_t unused_tail_in_bits = 0; ///< the bits behind the last value of a block with multiple tuples
+
+    const attribute & null_bitmap() const { return attributes.back(); }
+
+    /** Returns the bits of the values of all attributes, without the NULL bitmap. */
+    uint64_t payload_in_bits() const;
+    /** Returns the alignment padding of all attributes and tuples, without the padding of the NULL bitmap. */
+    uint64_t padding_in_bits() const;
+};
+
+/** Computes the footprint of \p layout for the attributes of \p schema by walking the layout tree. */
+layout_footprint compute_footprint(const m::Schema &schema, const m::storage::DataLayout &layout);
+
+/** Prints a report of \p footprint to \p out, one line per attribute and per kind of overhead, with the bytes per tuple
+ * and the bytes used by \p num_rows tuples, followed by the bytes of \p allocated_bytes that are not used by blocks. */
+void print_footprint(std::ostream &out, const m::Schema &schema, const layout_footprint &footprint,
+                     std::size_t num_rows, std::size_t allocated_bytes);
+
+/** Prints \p footprint to \p out as CSV lines `<prefix>,<component>,<payload bits>,<padding bits>,<bytes per tuple>`,
+ * with the bits per block, where the components are the attribute names, `NULL bitmap`, `padding`, `header`, and
+ * `unused tail`. */
+void print_footprint_csv(std::ostream &out, const std::string &prefix, const m::Schema &schema,
+                         const layout_footprint &footprint);
@@ -1,22 +1,83 @@
+#include "csv_loader.hpp"
 #include "data_layouts.hpp"
+#include "dictionary.hpp"
+#include "memory_policy.hpp"
+#include "memory_report.hpp"
+#include "snapshot.hpp"
 #include <cerrno>
 #include <cstddef>
 #include <cstdlib>
 #include <cstring>
+#include <filesystem>
 #include <fstream>
 #include <functional>
 #include <iostream>
 #include <memory>
+#include <stdexcept>
 #include <mutable/mutable.hpp>
+#include <unistd.h>
+#include <unordered_map>
 
 
 int main(int argc, const char **argv)
 {
-    /* Check the number of parameters. */
-    if (argc != 4) {
-        std::cerr << "Usage: " << argv[0] << " <Layout> <CSV-File> <SQL-File>" << std::endl;
+    auto usage = [argv]() {
+        std::cerr << "Usage: " << argv[0] << " <Layout> <CSV-File> <SQL-File> [--dictionary] "
+                     "[--memory=[<table>:]<policy>]... [--threads=<n>] [--simd] [--snapshot=<file>] "
+                     "[--footprint]\n"
+                     "  <policy> is a comma-separated list of `huge`, `interleave`, and `bind=<node>`\n"
+                     "  --threads=<n> loads the CSV file with <n> threads instead of a single one\n"
+                     "  --simd splits fields with the vectorized tokenizer (with one thread unless --threads is given)\n"
+                     "  --snapshot=<file> restores 'packages' from <file> if it is newer than the CSV file, and writes "
+                     "<file> after loading the CSV file otherwise\n"
+                     "  --footprint reports the memory used by the layout of 'packages' on stderr after loading"
+                  << std::endl;
         exit(EXIT_FAILURE);
+    };
+
+    /* Check the number of parameters and parse the options. */
+    if (argc < 4)
+        usage();
+    bool dictionary_encode = false;
+    unsigned num_threads = 0; // load with mutable's loader
+    bool vectorized = false;
+    bool report_footprint = false;
+    std::filesystem::path snapshot_file;
+    MemoryPolicy default_policy;
+    std::unordered_map<std::string, MemoryPolicy> table_policies;
+    for (int i = 4; i != argc; ++i) {
+        if (std::strcmp(argv[i], "--dictionary") == 0) {
+            dictionary_encode = true;
+        } else if (std::strncmp(argv[i], "--threads=", 10) == 0) {
+            num_threads = std::strtoul(argv[i] + 10, nullptr, 10);
+            if (num_threads == 0)
+                usage();
+        } else if (std::strcmp(argv[i], "--simd") == 0) {
+            vectorized = true;
+        } else if (std::strcmp(argv[i], "--footprint") == 0) {
+            report_footprint = true;
+        } else if (std::strncmp(argv[i], "--snapshot=", 11) == 0) {
+            snapshot_file = argv[i] + 11;
+        } else if (std::strncmp(argv[i], "--memory=", 9) == 0) {
+            const std::string arg = argv[i] + 9;
+            const auto colon = arg.find(':');
+            try {
+                if (colon == std::string::npos)
+                    default_policy = MemoryPolicy::Parse(arg);
+                else
+                    table_policies[arg.substr(0, colon)] = MemoryPolicy::Parse(arg.substr(colon + 1));
+            } catch (const std::invalid_argument &e) {
+                std::cerr << e.what() << std::endl;
+                usage();
+            }
+        } else {
+            usage();
+        }
     }
+    if (vectorized and num_threads == 0)
+        num_threads = 1;
+    std::filesystem::path csv_file = argv[2];
+    std::filesystem::path sql_file = argv[3];
 
     /* Get a handle on the catalog. */
     auto &C = m::Catalog::Get();
@@ -27,7 +88,32 @@ int main(int argc, const char **argv)
     /* Register our store(s) and set the default store. */
     C.register_data_layout("row_naive", std::make_unique<MyNaiveRowLayoutFactory>(), "row layout (naïve)");
     C.register_data_layout("row_optimized", std::make_unique<MyOptimizedRowLayoutFactory>(), "row layout (optimized)");
+    C.register_data_layout("row_optimized_notnull", std::make_unique<MyOptimizedRowLayoutFactory>(false),
+                           "row layout (optimized) for tables without NULL values");
+    C.register_data_layout("row_packed", std::make_unique<MyPackedRowLayoutFactory>(), "row layout (minimal padding)");
     C.register_data_layout("PAX4k", std::make_unique<MyPAX4kLayoutFactory>(), "PAX layout with 4KiB blocks");
+    C.register_data_layout("PAX16k", std::make_unique<MyPAXLayoutFactory>(16 * 1024), "PAX layout with 16KiB blocks");
+    C.register_data_layout("PAX64k", std::make_unique<MyPAXLayoutFactory>(64 * 1024), "PAX layout with 64KiB blocks");
+    C.register_data_layout("PAX256k", std::make_unique<MyPAXLayoutFactory>(256 * 1024), "PAX layout with 256KiB blocks");
+    C.register_data_layout("PAX2M", std::make_unique<MyPAXLayoutFactory>(2 * 1024 * 1024), "PAX layout with 2MiB blocks");
+    C.register_data_layout("PAXauto", std::make_unique<MyPAXAutoLayoutFactory>(), "PAX layout with blocks fit to the caches");
+    C.register_data_layout("DSM", std::make_unique<MyDSMLayoutFactory>(), "columnar layout (DSM)");
+    {
+        /* Derive the hot attributes of 'packages' from the queries in the SQL file. */
+        std::ifstream queries(argv[3]);
+        auto access_frequencies = compute_access_frequencies(
+            { "id", "repo", "pkg_name", "pkg_ver", "description", "licenses", "size", "packager" }, queries
+        );
+        std::vector<std::size_t> hot;
+        for (std::size_t idx = 0; idx != access_frequencies.size(); ++idx) {
+            if (access_frequencies[idx] >= .5)
+                hot.push_back(idx);
+        }
+        C.register_data_layout("hybrid", std::make_unique<MyHybridLayoutFactory>(std::move(access_frequencies)),
+                               "hybrid layout with hot attributes in rows and cold attributes in PAX minipages");
+        C.register_data_layout("row_cache_aligned", std::make_unique<MyCacheAlignedRowLayoutFactory>(std::move(hot)),
+                               "row layout with hot attributes not crossing cache lines");
+    }
 
     /* Set default data layout. */
     C.default_data_layout(argv[1]);
@@ -36,29 +122,139 @@ int main(int argc, const char **argv)
     auto &DB = C.add_database(C.pool("dbsys"));
     C.set_database_in_use(DB);
 
+    /* With `--dictionary`, the low-cardinality text attributes `repo`, `licenses`, and `packager` are stored as codes
+     * into per-attribute dictionaries.  The dictionaries are tables 'packages_<attribute>' with attributes `code` and
+     * `value`.  Equality predicates between these attributes and string literals in the SQL file are rewritten into
+     * code comparisons. */
+    struct encoded_attribute { const char *name; std::size_t column; std::size_t length; };
+    const std::vector<encoded_attribute> encoded_attributes = { { "repo", 1, 10 }, { "licenses", 5, 32 }, { "packager", 7, 32 } };
+    std::vector<Dictionary> dicts;
+    std::vector<std::filesystem::path> tmp_files;
+
+    if (dictionary_encode) {
+        std::vector<std::size_t> columns, max_lengths;
+        for (auto &attr : encoded_attributes) {
+            columns.push_back(attr.column);
+            max_lengths.push_back(attr.length);
+        }
+
+        const auto tmp_dir = std::filesystem::temp_directory_path();
+        std::ifstream in(csv_file);
+        csv_file = tmp_files.emplace_back(tmp_dir / ("packages." + std::to_string(getpid()) + ".csv"));
+        std::ofstream out(csv_file);
+        dicts = dictionary_encode_CSV(in, out, columns, max_lengths);
+
+        std::unordered_map<std::string, const Dictionary*> attributes;
+        for (std::size_t i = 0; i != encoded_attributes.size(); ++i)
+            attributes.emplace(encoded_attributes[i].name, &dicts[i]);
+
+        std::ifstream sql_in(sql_file);
+        const std::string sql{std::istreambuf_iterator<char>(sql_in), std::istreambuf_iterator<char>()};
+        sql_file = tmp_files.emplace_back(tmp_dir / ("packages." + std::to_string(getpid()) + ".sql"));
+        std::ofstream(sql_file) << rewrite_dictionary_predicates(sql, attributes);
+    }
+
+    /* Backs table `T` with a store whose memory is placed according to the policy given for `T`, or the default
+     * policy. */
+    auto create_store = [&](m::Table &T) {
+        T.store(C.create_store(T));
+        auto it = table_policies.find(T.name);
+        const auto &policy = it == table_policies.end() ? default_policy : it->second;
+        if (not policy.is_default() and not apply_memory_policy(T.store(), policy))
+            std::cerr << "warning: could not apply the memory policy of table '" << T.name << "'" << std::endl;
+    };
+
+    /* Returns the type of a text attribute of 'packages', i.e. a code type if the attribute is dictionary-encoded. */
+    auto text_type = [&](const char *name, std::size_t length) -> const m::Type* {
+        for (std::size_t i = 0; i != dicts.size(); ++i) {
+            if (std::strcmp(encoded_attributes[i].name, name) == 0)
+                return dicts[i].code_type_for();
+        }
+        return m::Type::Get_Char(m::Type::TY_Vector, length);
+    };
+
     /* Create table 'packages'. */
     auto &T = DB.add_table(C.pool("packages"));
     T.push_back(C.pool("id"),           m::Type::Get_Integer(m::Type::TY_Vector, 4));
-    T.push_back(C.pool("repo"),         m::Type::Get_Char(m::Type::TY_Vector, 10));
+    T.push_back(C.pool("repo"),         text_type("repo", 10));
     T.push_back(C.pool("pkg_name"),     m::Type::Get_Char(m::Type::TY_Vector, 32));
     T.push_back(C.pool("pkg_ver"),      m::Type::Get_Char(m::Type::TY_Vector, 20));
     T.push_back(C.pool("description"),  m::Type::Get_Char(m::Type::TY_Vector, 80));
-    T.push_back(C.pool("licenses"),     m::Type::Get_Char(m::Type::TY_Vector, 32));
+    T.push_back(C.pool("licenses"),     text_type("licenses", 32));
     T.push_back(C.pool("size"),         m::Type::Get_Integer(m::Type::TY_Vector, 8));
-    T.push_back(C.pool("packager"),     m::Type::Get_Char(m::Type::TY_Vector, 32));
+    T.push_back(C.pool("packager"),     text_type("packager", 32));
 
     /* Back the table with a store and set the data layout. */
-    T.store(C.create_store(T));
+    create_store(T);
     T.layout(C.data_layout());
 
+    /* Restore table 'T' from the snapshot, unless it is missing or older than the CSV file, which is the original one
+     * even with `--dictionary`. */
+    bool restored = false;
+    if (not snapshot_file.empty() and std::filesystem::exists(snapshot_file) and
+        std::filesystem::last_write_time(snapshot_file) >= std::filesystem::last_write_time(argv[2]))
+    {
+        try {
+            open_snapshot(T, snapshot_file);
+            restored = true;
+        } catch (const std::runtime_error &e) {
+            std::cerr << "warning: not using the snapshot: " << e.what() << std::endl;
+        }
+    }
+
     /* Load CSV file into table 'T'. */
-    m::load_from_CSV(diag, T, argv[2], std::numeric_limits<std::size_t>::max(), true, false);
+    if (restored) {
+        /* nothing to be done */
+    } else if (num_threads) {
+        try {
+            load_CSV_parallel(T, csv_file, num_threads, true, ',', '"', '\\', vectorized);
+        } catch (const std::exception &e) {
+            std::cerr << "Could not load " << csv_file << ": " << e.what() << std::endl;
+            exit(EXIT_FAILURE);
+        }
+    } else {
+        m::load_from_CSV(diag, T, csv_file, std::numeric_limits<std::size_t>::max(), true, false);
+    }
+    if (not restored and not snapshot_file.empty()) {
+        try {
+            write_snapshot(T, snapshot_file);
+        } catch (const std::runtime_error &e) {
+            std::cerr << "warning: could not write the snapshot: " << e.what() << std::endl;
+        }
+    }
+
+    if (report_footprint) {
+        std::cerr << "footprint of 'packages' in layout " << argv[1] << ": ";
+        print_footprint(std::cerr, T.schema(), compute_footprint(T.schema(), T.layout()), T.store().num_rows(),
+                        T.store().memory().size());
+    }
+
+    /* Create and load the dictionary tables. */
+    for (std::size_t i = 0; i != dicts.size(); ++i) {
+        const std::string name = std::string("packages_") + encoded_attributes[i].name;
+        auto &D = DB.add_table(C.pool(name.c_str()));
+        D.push_back(C.pool("code"),  dicts[i].code_type_for());
+        D.push_back(C.pool("value"), m::Type::Get_Char(m::Type::TY_Vector, encoded_attributes[i].length));
+        create_store(D);
+        D.layout(C.data_layout());
+
+        const auto dict_file = tmp_files.emplace_back(std::filesystem::temp_directory_path() /
+                                                      (name + '.' + std::to_string(getpid()) + ".csv"));
+        {
+            std::ofstream out(dict_file);
+            write_dictionary_CSV(out, dicts[i]);
+        }
+        m::load_from_CSV(diag, D, dict_file, std::numeric_limits<std::size_t>::max(), true, false);
+    }
 
     if (diag.num_errors())
         exit(EXIT_FAILURE);
 
     /* Process the SQL file. */
-    m::execute_file(diag, argv[3]);
+    m::execute_file(diag, sql_file);
+
+    for (auto &file : tmp_files)
+        std::filesystem::remove(file);
 
     m::Catalog::Destroy();
     exit(EXIT_SUCCESS);
@@ -0,0 +1,64 @@
+#include "parallel_scan.hpp"
+#include <algorithm>
+
+
+using namespace m;
+using namespace m::storage;
+
+
+namespace {
+
+uint64_t pack(uint64_t front, uint64_t back) { return front << 32 | back; }
+uint64_t front_of(uint64_t range) { return range >> 32; }
+uint64_t back_of(uint64_t range) { return range & 0xffffffff; }
+
+}
+
+std::vector<morsel> make_morsels(const DataLayout &layout, std::size_t num_rows, std::size_t morsel_size)
+{
+    /* Round the morsel size to whole blocks. */
+    const std::size_t tuples_per_block = layout.child().num_tuples();
+    morsel_size = std::max<std::size_t>(morsel_size, 1);
+    morsel_size = (morsel_size + tuples_per_block - 1) / tuples_per_block * tuples_per_block;
+
+    std::vector<morsel> morsels;
+    for (std::size_t row = 0; row < num_rows; row += morsel_size)
+        morsels.push_back({ row, std::min(morsel_size, num_rows - row) });
+    return morsels;
+}
+
+MorselQueue::MorselQueue(std::vector<morsel> morsels, std::size_t num_workers)
+    : morsels_(std::move(morsels))
+    , ranges_(new std::atomic<uint64_t>[std::max<std::size_t>(num_workers, 1)])
+    , num_workers_(std::max<std::size_t>(num_workers, 1))
+{
+    M_insist(morsels_.size() < (uint64_t(1) << 32), "too many morsels");
+    for (std::size_t w = 0; w != num_workers_; ++w)
+        ranges_[w] = pack(w * morsels_.size() / num_workers_, (w + 1) * morsels_.size() / num_workers_);
+}
+
+std::size_t MorselQueue::take(std::size_t worker, bool front)
+{
+    auto &range = ranges_[worker];
+    uint64_t current = range.load(std::memory_order_relaxed);
+    for (;;) {
+        const uint64_t f = front_of(current), b = back_of(current);
+        if (f >= b)
+            return -1;
+        const uint64_t next = front ? pack(f + 1, b) : pack(f, b - 1);
+        if (range.compare_exchange_weak(current, next, std::memory_order_acq_rel, std::memory_order_relaxed))
+            return front ? f : b - 1;
+    }
+}
+
+std::size_t MorselQueue::next(std::size_t worker)
+{
+    if (std::size_t m = take(worker, true); m != std::size_t(-1))
+        return m;
+    /* Steal from the other workers, beginning with the next one. */
+    for (std::size_t i = 1; i != num_workers_; ++i) {
+        if (std::size_t m = take((worker + i) % num_workers_, false); m != std::size_t(-1))
+            return m;
+    }
+    return -1;
+}
@@ -0,0 +1,105 @@
+#pragma once
+
+#include "scan_kernels.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <mutable/mutable.hpp>
+#include <thread>
+#include <utility>
+#include <vector>
+
+
+/** A range of tuples that a worker of a parallel scan processes at once. */
+struct morsel
+{
+    std::size_t first_row;
+    std::size_t num_rows;
+};
+
+/** Splits the \p num_rows tuples stored in \p layout into morsels of about \p morsel_size tuples.  Morsels of layouts
+ * with blocks consist of whole blocks, such that no two workers touch the same block; morsels of row layouts are fixed
+ * row ranges. */
+std::vector<morsel> make_morsels(const m::storage::DataLayout &layout, std::size_t num_rows,
+                                 std::size_t morsel_size = 16 * 1024);
+
+/** Distributes morsels among workers.  Every worker owns a contiguous range of morsels, initially of equal size, and
+ * takes morsels from its front.  A worker whose range is exhausted steals morsels from the back of the ranges of the
+ * other workers.  The front and back of a range are packed into one atomic word, hence taking and stealing are a
+ * single compare-and-swap each. */
+class MorselQueue
+{
+    std::vector<morsel> morsels_;
+    std::unique_ptr<std::atomic<uint64_t>[]> ranges_; ///< per worker, the front in the high and back in the low half
+    std::size_t num_workers_;
+
+    public:
+    MorselQueue(std::vector<morsel> morsels, std::size_t num_workers);
+
+    std::size_t num_workers() const { return num_workers_; }
+    const std::vector<morsel> & morsels() const { return morsels_; }
+
+    /** Returns the index of the next morsel for worker \p worker, taken from its own range or stolen from another
+     * worker, or `-1` if all morsels are taken. */
+    std::size_t next(std::size_t worker);
+
+    private:
+    /** Takes the first morsel of the range of \p worker if \p front, otherwise the last one.  Returns its index or
+     * `-1` if the range is empty. */
+    std::size_t take(std::size_t worker, bool front);
+};
+
+/** Scans the attributes \p attrs of the \p num_rows tuples of \p schema stored in \p layout at \p memory with
+ * \p num_threads threads.  Every thread copies \p prototype into its own consumer, takes morsels from a `MorselQueue`,
+ * reads them with `scan_columns()` in chunks of up to \p chunk_size tuples, and calls its consumer with the arrays of
+ * the projected values and the number of tuples of every chunk, like a `m::CallbackOperator` for batches.  Returns
+ * the consumers of all threads, whose results the caller merges.  Rethrows the first exception thrown by a consumer. */
+template<typename Consumer>
+std::vector<Consumer> parallel_scan(const m::Schema &schema, const m::storage::DataLayout &layout,
+                                    const void *memory, std::size_t num_rows, const std::vector<std::size_t> &attrs,
+                                    unsigned num_threads, const Consumer &prototype, std::size_t chunk_size = 1024)
+{
+    num_threads = std::max(num_threads, 1U);
+    MorselQueue queue(make_morsels(layout, num_rows), num_threads);
+    std::vector<Consumer> consumers(num_threads, prototype);
+    std::vector<std::exception_ptr> errors(num_threads);
+
+    auto work = [&](std::size_t worker) {
+        try {
+            /* A local consumer, to not share cache lines with the consumers of other threads. */
+            Consumer consumer(prototype);
+            std::vector<std::vector<uint64_t>> buffers;
+            std::vector<void*> outputs;
+            for (std::size_t attr : attrs) {
+                const std::size_t size = std::max<std::size_t>(schema[attr].type->size() / 8, sizeof(bool));
+                buffers.emplace_back((chunk_size * size + 7) / 8);
+                outputs.push_back(buffers.back().data());
+            }
+            for (std::size_t m; (m = queue.next(worker)) != std::size_t(-1);) {
+                const morsel &M = queue.morsels()[m];
+                for (std::size_t i = 0; i < M.num_rows; i += chunk_size) {
+                    const std::size_t n = std::min(chunk_size, M.num_rows - i);
+                    scan_columns(schema, layout, memory, M.first_row + i, n, attrs, outputs.data());
+                    consumer(static_cast<const void *const*>(outputs.data()), n);
+                }
+            }
+            consumers[worker] = std::move(consumer);
+        } catch (...) {
+            errors[worker] = std::current_exception();
+        }
+    };
+    {
+        std::vector<std::jthread> threads;
+        for (std::size_t worker = 1; worker < num_threads; ++worker)
+            threads.emplace_back(work, worker);
+        work(0);
+    }
+    for (auto &error : errors) {
+        if (error)
+            std::rethrow_exception(error);
+    }
+    return consumers;
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstdint>
+
+#ifdef __linux__
+#include <cstring>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+
+/** A hardware performance counter of the calling thread, read through `perf_event_open(2)`.  If the counter cannot be
+ * opened, e.g. in a container or due to a restrictive `perf_event_paranoid`, `available()` is `false` and `read()`
+ * returns 0. */
+struct PerfCounter
+{
+    private:
+    int fd_ = -1;
+
+    public:
+#ifdef __linux__
+    PerfCounter(uint32_t type, uint64_t config)
+    {
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = type;
+        attr.config = config;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        fd_ = syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+    }
+
+    /** Returns a counter of load misses in the data TLB. */
+    static PerfCounter DTLB_Load_Misses() {
+        return PerfCounter(PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_DTLB |
+                                               (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                                               (PERF_COUNT_HW_CACHE_RESULT_MISS << 16));
+    }
+#else
+    PerfCounter(uint32_t, uint64_t) { }
+
+    static PerfCounter DTLB_Load_Misses() { return PerfCounter(0, 0); }
+#endif
+
+    PerfCounter(const PerfCounter&) = delete;
+    PerfCounter(PerfCounter &&other) : fd_(other.fd_) { other.fd_ = -1; }
+    ~PerfCounter() {
+#ifdef __linux__
+        if (available())
+            close(fd_);
+#endif
+    }
+
+    bool available() const { return fd_ >= 0; }
+
+    /** Resets the counter to 0 and starts counting. */
+    void start() {
+#ifdef __linux__
+        if (available()) {
+            ioctl(fd_, PERF_EVENT_IOC_RESET, 0);
+            ioctl(fd_, PERF_EVENT_IOC_ENABLE, 0);
+        }
+#endif
+    }
+
+    /** Stops counting. */
+    void stop() {
+#ifdef __linux__
+        if (available())
+            ioctl(fd_, PERF_EVENT_IOC_DISABLE, 0);
+#endif
+    }
+
+    /** Returns the number of events counted. */
+    uint64_t read() const {
+        uint64_t count = 0;
+#ifdef __linux__
+        if (available() and ::read(fd_, &count, sizeof(count)) != sizeof(count))
+            count = 0;
+#endif
+        return count;
+    }
+};
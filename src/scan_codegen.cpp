@@ -0,0 +1,76 @@
+#include "data_layouts.hpp"
+#include "scan_kernels.hpp"
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutable/mutable.hpp>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+
+/** Generates `scan_kernels_generated.cpp`, i.e. the `ScanKernel`s of the scans of `benchmark/milestone1.cpp` in our
+ * row and PAX layouts. */
+int main(int argc, const char **argv)
+{
+    if (argc > 2) {
+        std::cerr << "Usage: " << argv[0] << " [<Output-File>]" << std::endl;
+        exit(EXIT_FAILURE);
+    }
+
+    std::vector<std::pair<const char*, std::unique_ptr<m::storage::DataLayoutFactory>>> factories;
+    factories.emplace_back("row_naive", std::make_unique<MyNaiveRowLayoutFactory>());
+    factories.emplace_back("row_optimized", std::make_unique<MyOptimizedRowLayoutFactory>());
+    factories.emplace_back("row_optimized_notnull", std::make_unique<MyOptimizedRowLayoutFactory>(false));
+    factories.emplace_back("PAX4k", std::make_unique<MyPAX4kLayoutFactory>());
+
+    /* The tables of the full and partial scan, and their projections. */
+    auto &C = m::Catalog::Get();
+    auto &DB = C.add_database(C.pool("scan_codegen"));
+    auto &table = DB.add_table(C.pool("full_scan"));
+    table.push_back(C.pool("key"),    m::Type::Get_Integer(m::Type::TY_Vector, 4));
+    table.push_back(C.pool("value0"), m::Type::Get_Integer(m::Type::TY_Vector, 4));
+    table.push_back(C.pool("value1"), m::Type::Get_Integer(m::Type::TY_Vector, 4));
+    table.push_back(C.pool("value2"), m::Type::Get_Integer(m::Type::TY_Vector, 4));
+    const std::vector<std::pair<const char*, std::vector<std::size_t>>> scans = {
+        { "full_scan", { 0, 1, 2, 3 } },
+        { "partial_scan", { 0, 3 } },
+    };
+
+    std::ofstream file;
+    if (argc == 2)
+        file.open(argv[1]);
+    std::ostream &out = argc == 2 ? file : std::cout;
+    out << "/* Generated by `scan_codegen`, do not edit. */\n"
+        << "#include \"scan_kernels.hpp\"\n"
+        << "\n\n"
+        << "void register_generated_scan_kernels(ScanKernelRegistry &R)\n"
+        << "{\n";
+    /* Generate one kernel per distinct layout and projection, named after all scans it serves. */
+    struct kernel { m::storage::DataLayout layout; std::vector<std::size_t> attrs; std::string comment; };
+    std::vector<kernel> kernels;
+    std::unordered_map<uint64_t, std::size_t> kernel_indices;
+    for (auto &[layout_name, factory] : factories) {
+        for (auto &[scan_name, attrs] : scans) {
+            auto layout = factory->make(table.schema());
+            const std::string name = std::string(scan_name) + " in " + layout_name;
+            auto [it, inserted] = kernel_indices.emplace(scan_kernel_key(layout, attrs), kernels.size());
+            if (inserted)
+                kernels.push_back({ std::move(layout), attrs, name });
+            else
+                kernels[it->second].comment += ", " + name;
+        }
+    }
+    for (std::size_t i = 0; i != kernels.size(); ++i)
+        out << (i ? "\n" : "") << generate_scan_kernel(table.schema(), kernels[i].layout, kernels[i].attrs,
+                                                       kernels[i].comment);
+    out << "}\n";
+
+    m::Catalog::Destroy();
+    if (not out) {
+        std::cerr << "Could not write the scan kernels" << std::endl;
+        exit(EXIT_FAILURE);
+    }
+}
@@ -0,0 +1,171 @@
+#include "scan_kernels.hpp"
+#include "data_layouts.hpp"
+#include "snapshot.hpp"
+#include <algorithm>
+#include <sstream>
+#include <stdexcept>
+
+
+using namespace m;
+using namespace m::storage;
+
+
+uint64_t scan_kernel_key(const DataLayout &layout, const std::vector<std::size_t> &attrs)
+{
+    uint64_t key = layout_fingerprint(layout);
+    for (std::size_t attr : attrs)
+        key = (key ^ (attr + 1)) * 0x100000001b3ULL;
+    return key;
+}
+
+ScanKernelRegistry & ScanKernelRegistry::Get()
+{
+    static ScanKernelRegistry registry = []() {
+        ScanKernelRegistry R;
+        register_generated_scan_kernels(R);
+        return R;
+    }();
+    return registry;
+}
+
+void read_columns(const Schema &schema, const DataLayout &layout, const void *memory, std::size_t first_row,
+                  std::size_t num_rows, const std::vector<std::size_t> &attrs, void *const *outputs)
+{
+    auto bytes = static_cast<const uint8_t*>(memory);
+    for (std::size_t k = 0; k != attrs.size(); ++k) {
+        const auto path = compute_attribute_path(layout, attrs[k]);
+        const Type *type = schema[attrs[k]].type;
+
+        if (type->is_boolean()) {
+            auto out = static_cast<bool*>(outputs[k]);
+            for (std::size_t i = 0; i != num_rows; ++i) {
+                const uint64_t offset = path.offset_in_bits(first_row + i);
+                out[i] = (bytes[offset / 8] >> (offset % 8)) & 1;
+            }
+            continue;
+        }
+
+        const std::size_t size = type->size() / 8;
+        const std::size_t stride = path.tuple_stride_in_bits() / 8;
+        auto out = static_cast<uint8_t*>(outputs[k]);
+        for (std::size_t i = 0; i != num_rows;) {
+            const uint8_t *p = bytes + path.offset_in_bits(first_row + i) / 8;
+            const std::size_t n = std::min(num_rows - i, path.num_strided_rows(first_row + i));
+            if (stride == size) {
+                std::memcpy(out + i * size, p, n * size);
+            } else {
+                for (std::size_t j = 0; j != n; ++j)
+                    std::memcpy(out + (i + j) * size, p + j * stride, size);
+            }
+            i += n;
+        }
+    }
+}
+
+void read_columns_prefetched(const Schema &schema, const DataLayout &layout, const void *memory,
+                             std::size_t first_row, std::size_t num_rows, const std::vector<std::size_t> &attrs,
+                             void *const *outputs, std::size_t prefetch_distance)
+{
+    constexpr std::size_t CACHE_LINE_SIZE = 64;
+
+    std::vector<attribute_path> paths;
+    std::vector<std::size_t> sizes, strides;
+    for (std::size_t attr : attrs) {
+        if (schema[attr].type->is_boolean())
+            throw std::invalid_argument("cannot prefetch Booleans");
+        paths.push_back(compute_attribute_path(layout, attr));
+        sizes.push_back(schema[attr].type->size() / 8);
+        strides.push_back(paths.back().tuple_stride_in_bits() / 8);
+    }
+    const std::size_t n_attrs = attrs.size();
+    auto bytes = static_cast<const uint8_t*>(memory);
+    std::vector<const uint8_t*> values(n_attrs);
+    std::vector<uint8_t*> out(n_attrs);
+    for (std::size_t k = 0; k != n_attrs; ++k)
+        out[k] = static_cast<uint8_t*>(outputs[k]);
+
+    for (std::size_t i = 0; i != num_rows;) {
+        /* Find the values of the first tuple of the run, and the attributes to prefetch: those whose values are at
+         * least a cache line behind the last attribute prefetched. */
+        std::size_t n = num_rows - i;
+        for (std::size_t k = 0; k != n_attrs; ++k) {
+            values[k] = bytes + paths[k].offset_in_bits(first_row + i) / 8;
+            n = std::min(n, paths[k].num_strided_rows(first_row + i));
+        }
+        std::vector<std::size_t> prefetched;
+        if (prefetch_distance) {
+            std::vector<std::size_t> by_address(n_attrs);
+            for (std::size_t k = 0; k != n_attrs; ++k)
+                by_address[k] = k;
+            std::sort(by_address.begin(), by_address.end(), [&](auto a, auto b) { return values[a] < values[b]; });
+            for (std::size_t k : by_address) {
+                if (prefetched.empty() or values[k] >= values[prefetched.back()] + CACHE_LINE_SIZE or
+                    strides[k] != strides[prefetched.back()])
+                    prefetched.push_back(k);
+            }
+        }
+
+        for (std::size_t j = 0; j != n; ++j) {
+            if (j + prefetch_distance < n) {
+                for (std::size_t k : prefetched) {
+                    /* Tuples narrower than a cache line share it, prefetch it only once. */
+                    const std::size_t offset = (j + prefetch_distance) * strides[k];
+                    if (strides[k] >= CACHE_LINE_SIZE or offset % CACHE_LINE_SIZE < strides[k])
+                        __builtin_prefetch(values[k] + offset);
+                }
+            }
+            for (std::size_t k = 0; k != n_attrs; ++k)
+                std::memcpy(out[k] + (i + j) * sizes[k], values[k] + j * strides[k], sizes[k]);
+        }
+        i += n;
+    }
+}
+
+bool scan_columns(const Schema &schema, const DataLayout &layout, const void *memory, std::size_t first_row,
+                  std::size_t num_rows, const std::vector<std::size_t> &attrs, void *const *outputs)
+{
+    if (auto kernel = ScanKernelRegistry::Get().find(layout, attrs)) {
+        kernel(memory, first_row, num_rows, outputs);
+        return true;
+    }
+    read_columns(schema, layout, memory, first_row, num_rows, attrs, outputs);
+    return false;
+}
+
+std::string generate_scan_kernel(const Schema &schema, const DataLayout &layout, const std::vector<std::size_t> &attrs,
+                                 const std::string &comment)
+{
+    auto unsupported = [](const std::string &reason) { return std::invalid_argument("no scan kernel: " + reason); };
+
+    /* The root holds the blocks, unless it holds a single tuple, like a row does. */
+    auto &root = layout.child();
+    const std::size_t tuples_per_block = root.num_tuples() == 1 ? 0 : root.num_tuples();
+    const uint64_t block_stride_in_bits = tuples_per_block ? layout.stride_in_bits() : 0;
+
+    std::ostringstream fields;
+    for (std::size_t attr : attrs) {
+        const Type *type = schema[attr].type;
+        if (type->is_boolean())
+            throw unsupported("attribute " + std::to_string(attr) + " is a Boolean");
+        const auto path = compute_attribute_path(layout, attr);
+        if (tuples_per_block and path.levels[1].num_tuples != 1)
+            throw unsupported("attribute " + std::to_string(attr) + " is nested in multiple levels of blocks");
+
+        /* All levels below the block contribute their offset only. */
+        uint64_t offset_in_bits = 0;
+        for (std::size_t i = tuples_per_block ? 1 : 0; i != path.levels.size(); ++i)
+            offset_in_bits += path.levels[i].offset_in_bits;
+        const uint64_t stride_in_bits = path.tuple_stride_in_bits();
+        if (type->size() % 8 or offset_in_bits % 8 or stride_in_bits % 8 or block_stride_in_bits % 8)
+            throw unsupported("attribute " + std::to_string(attr) + " is not byte-aligned");
+
+        fields << ",\n          scan_field<" << type->size() / 8 << ", " << offset_in_bits / 8 << ", "
+               << stride_in_bits / 8 << '>';
+    }
+
+    std::ostringstream out;
+    out << "    /* " << comment << " */\n"
+        << "    R.add(0x" << std::hex << scan_kernel_key(layout, attrs) << std::dec << "ULL, &ScanKernel<"
+        << tuples_per_block << ", " << block_stride_in_bits / 8 << fields.str() << ">::scan);\n";
+    return out.str();
+}
@@ -0,0 +1,129 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <mutable/mutable.hpp>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+
+/** A projected attribute of a `ScanKernel`: values of \tparam Size bytes, at \tparam Offset bytes within a block and
+ * \tparam Stride bytes apart. */
+template<std::size_t Size, std::size_t Offset, std::size_t Stride>
+struct scan_field
+{
+    static constexpr std::size_t size = Size;
+    static constexpr std::size_t offset = Offset;
+    static constexpr std::size_t stride = Stride;
+};
+
+/** A scan over a layout whose tuples are stored in blocks of \tparam TuplesPerBlock tuples, \tparam BlockStride bytes
+ * apart, that copies the values of the projected \tparam Fields into dense arrays.  A \tparam TuplesPerBlock of 0
+ * means a single unbounded block, e.g. of a row layout.  All offsets and strides are compile-time constants, such that
+ * the compiler can unroll and vectorize the copy loops instead of interpreting the layout tree. */
+template<std::size_t TuplesPerBlock, std::size_t BlockStride, typename... Fields>
+struct ScanKernel
+{
+    /** Copies the values of the tuples \p first_row, ..., \p first_row + \p num_rows - 1 stored at \p memory to
+     * \p outputs, one array per field. */
+    static void scan(const void *memory, std::size_t first_row, std::size_t num_rows, void *const *outputs)
+    {
+        auto bytes = static_cast<const uint8_t*>(memory);
+        if constexpr (TuplesPerBlock == 0) {
+            scan_block(bytes, first_row, num_rows, outputs, 0);
+        } else {
+            for (std::size_t i = 0; i != num_rows;) {
+                const std::size_t row = first_row + i;
+                const std::size_t n = std::min(TuplesPerBlock - row % TuplesPerBlock, num_rows - i);
+                scan_block(bytes + row / TuplesPerBlock * BlockStride, row % TuplesPerBlock, n, outputs, i);
+                i += n;
+            }
+        }
+    }
+
+    private:
+    static void scan_block(const uint8_t *block, std::size_t begin, std::size_t n, void *const *outputs,
+                           std::size_t out_begin)
+    {
+        std::size_t k = 0;
+        (gather<Fields>(block, begin, n, static_cast<uint8_t*>(outputs[k++]) + out_begin * Fields::size), ...);
+    }
+
+    template<typename Field>
+    static void gather(const uint8_t *block, std::size_t begin, std::size_t n, uint8_t *out)
+    {
+        const uint8_t *p = block + Field::offset + begin * Field::stride;
+        if constexpr (Field::stride == Field::size) {
+            std::memcpy(out, p, n * Field::size);
+        } else {
+            for (std::size_t j = 0; j != n; ++j)
+                std::memcpy(out + j * Field::size, p + j * Field::stride, Field::size);
+        }
+    }
+};
+
+/** The signature of `ScanKernel::scan()`. */
+using scan_kernel_t = void(*)(const void *memory, std::size_t first_row, std::size_t num_rows, void *const *outputs);
+
+/** Returns the key of a scan kernel for the attributes \p attrs of a table stored in \p layout. */
+uint64_t scan_kernel_key(const m::storage::DataLayout &layout, const std::vector<std::size_t> &attrs);
+
+/** Holds the scan kernels generated by `scan_codegen`, see `scan_kernels_generated.cpp`. */
+struct ScanKernelRegistry
+{
+    private:
+    std::unordered_map<uint64_t, scan_kernel_t> kernels_;
+
+    ScanKernelRegistry() = default;
+
+    public:
+    /** Returns the registry, with all generated kernels registered. */
+    static ScanKernelRegistry & Get();
+
+    void add(uint64_t key, scan_kernel_t kernel) { kernels_[key] = kernel; }
+
+    /** Returns the kernel for the attributes \p attrs of a table stored in \p layout, or `nullptr` if there is none. */
+    scan_kernel_t find(const m::storage::DataLayout &layout, const std::vector<std::size_t> &attrs) const {
+        auto it = kernels_.find(scan_kernel_key(layout, attrs));
+        return it == kernels_.end() ? nullptr : it->second;
+    }
+
+    std::size_t size() const { return kernels_.size(); }
+};
+
+/** Registers the kernels of `scan_kernels_generated.cpp` in \p registry. */
+void register_generated_scan_kernels(ScanKernelRegistry &registry);
+
+/** Copies the values of the attributes \p attrs of the tuples \p first_row, ..., \p first_row + \p num_rows - 1 of
+ * \p schema, stored in \p layout at \p memory, to \p outputs, one dense array per attribute with one element of the
+ * attribute's size per tuple.  Booleans are copied as `bool`s.  Interprets the layout tree and hence serves as fallback
+ * for layouts without generated kernel. */
+void read_columns(const m::Schema &schema, const m::storage::DataLayout &layout, const void *memory,
+                  std::size_t first_row, std::size_t num_rows, const std::vector<std::size_t> &attrs,
+                  void *const *outputs);
+
+/** Like `read_columns()`, but walks the tuples one at a time and issues software prefetches for the values of the tuple
+ * \p prefetch_distance tuples ahead.  The cache lines to prefetch are derived from the layout: one per projected
+ * attribute that does not share a cache line with a preceding one within the tuple, and, if tuples are narrower than a
+ * cache line, only for the first tuple of a cache line.  Meant for row layouts with wide strides, where projected
+ * attributes are sparse and hardware prefetchers fail to keep up.  A \p prefetch_distance of 0 disables prefetching.
+ * Throws `std::invalid_argument` if an attribute is a Boolean. */
+void read_columns_prefetched(const m::Schema &schema, const m::storage::DataLayout &layout, const void *memory,
+                             std::size_t first_row, std::size_t num_rows, const std::vector<std::size_t> &attrs,
+                             void *const *outputs, std::size_t prefetch_distance);
+
+/** Like `read_columns()`, but uses the generated kernel for \p layout and \p attrs if there is one.  Returns `true` iff
+ * a generated kernel was used. */
+bool scan_columns(const m::Schema &schema, const m::storage::DataLayout &layout, const void *memory,
+                  std::size_t first_row, std::size_t num_rows, const std::vector<std::size_t> &attrs,
+                  void *const *outputs);
+
+/** Returns a statement that registers a `ScanKernel` for the attributes \p attrs of \p schema stored in \p layout in a
+ * `ScanKernelRegistry` named `R`, preceded by a comment \p comment.  Throws `std::invalid_argument` if \p layout cannot
+ * be expressed by a `ScanKernel`, i.e. if an attribute is nested in more than one level of blocks, is a Boolean, or is
+ * not byte-aligned. */
+std::string generate_scan_kernel(const m::Schema &schema, const m::storage::DataLayout &layout,
+                                 const std::vector<std::size_t> &attrs, const std::string &comment);
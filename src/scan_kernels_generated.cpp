@@ -0,0 +1,42 @@
+/* Generated by `scan_codegen`, do not edit. */
+#include "scan_kernels.hpp"
+
+
+void register_generated_scan_kernels(ScanKernelRegistry &R)
+{
+    /* full_scan in row_naive, full_scan in row_optimized */
+    R.add(0x6d77cdfdb65c784cULL, &ScanKernel<0, 0,
+          scan_field<4, 0, 20>,
+          scan_field<4, 4, 20>,
+          scan_field<4, 8, 20>,
+          scan_field<4, 12, 20>>::scan);
+
+    /* partial_scan in row_naive, partial_scan in row_optimized */
+    R.add(0xf6f5f34c7b949fb5ULL, &ScanKernel<0, 0,
+          scan_field<4, 0, 20>,
+          scan_field<4, 12, 20>>::scan);
+
+    /* full_scan in row_optimized_notnull */
+    R.add(0x639669e0ba3f868cULL, &ScanKernel<0, 0,
+          scan_field<4, 0, 16>,
+          scan_field<4, 4, 16>,
+          scan_field<4, 8, 16>,
+          scan_field<4, 12, 16>>::scan);
+
+    /* partial_scan in row_optimized_notnull */
+    R.add(0xc052c48dd09943f5ULL, &ScanKernel<0, 0,
+          scan_field<4, 0, 16>,
+          scan_field<4, 12, 16>>::scan);
+
+    /* full_scan in PAX4k */
+    R.add(0x2dceae811b763155ULL, &ScanKernel<248, 4096,
+          scan_field<4, 0, 4>,
+          scan_field<4, 992, 4>,
+          scan_field<4, 1984, 4>,
+          scan_field<4, 2976, 4>>::scan);
+
+    /* partial_scan in PAX4k */
+    R.add(0x4e257e7c4b084e30ULL, &ScanKernel<248, 4096,
+          scan_field<4, 0, 4>,
+          scan_field<4, 2976, 4>>::scan);
+}
@@ -0,0 +1,225 @@
+#include "snapshot.hpp"
+#include <bit>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <unistd.h>
+
+
+using namespace m;
+using namespace m::storage;
+
+
+namespace {
+
+constexpr uint64_t FNV_OFFSET_BASIS = 0xcbf29ce484222325ULL;
+constexpr uint64_t FNV_PRIME = 0x100000001b3ULL;
+
+/** Hashes the \p size bytes at \p data into \p hash using FNV-1a. */
+void hash_bytes(uint64_t &hash, const void *data, std::size_t size)
+{
+    auto bytes = static_cast<const uint8_t*>(data);
+    for (std::size_t i = 0; i != size; ++i)
+        hash = (hash ^ bytes[i]) * FNV_PRIME;
+}
+
+void hash_value(uint64_t &hash, uint64_t value) { hash_bytes(hash, &value, sizeof(value)); }
+
+void hash_node(uint64_t &hash, const DataLayout::Node &node)
+{
+    hash_value(hash, node.num_tuples());
+    if (auto leaf = cast<const DataLayout::Leaf>(&node)) {
+        hash_value(hash, leaf->index());
+        hash_value(hash, leaf->type()->size());
+    } else {
+        auto &inode = as<const DataLayout::INode>(node);
+        hash_value(hash, inode.num_children());
+        for (auto &child : inode) {
+            hash_value(hash, child.offset_in_bits);
+            hash_value(hash, child.stride_in_bits);
+            hash_node(hash, *child.ptr);
+        }
+    }
+}
+
+/** Returns the names and types of the attributes of \p schema, one attribute per line. */
+std::string schema_text(const Schema &schema)
+{
+    std::ostringstream out;
+    for (auto &entry : schema)
+        out << entry.id.name << ' ' << *entry.type << '\n';
+    return out.str();
+}
+
+std::size_t page_size() { return sysconf(_SC_PAGESIZE); }
+
+std::size_t align_to_page(std::size_t size) { return (size + page_size() - 1) / page_size() * page_size(); }
+
+[[noreturn]] void throw_errno(const std::string &what, const std::filesystem::path &path)
+{
+    throw std::runtime_error(what + ' ' + path.string() + ": " + std::strerror(errno));
+}
+
+/** Reads exactly \p size bytes at \p offset of \p fd into \p buffer.  Returns `false` if the file is too short. */
+bool read_fully(int fd, void *buffer, std::size_t size, off_t offset)
+{
+    auto p = static_cast<char*>(buffer);
+    while (size) {
+        const ssize_t n = pread(fd, p, size, offset);
+        if (n <= 0)
+            return false;
+        p += n;
+        offset += n;
+        size -= n;
+    }
+    return true;
+}
+
+/** Closes a file descriptor on destruction. */
+struct file_descriptor
+{
+    int fd;
+    explicit file_descriptor(int fd) : fd(fd) { }
+    file_descriptor(const file_descriptor&) = delete;
+    ~file_descriptor() { if (fd >= 0) close(fd); }
+};
+
+}
+
+uint64_t schema_fingerprint(const Schema &schema)
+{
+    uint64_t hash = FNV_OFFSET_BASIS;
+    const std::string text = schema_text(schema);
+    hash_bytes(hash, text.data(), text.size());
+    return hash;
+}
+
+uint64_t layout_fingerprint(const DataLayout &layout)
+{
+    uint64_t hash = FNV_OFFSET_BASIS;
+    hash_value(hash, layout.stride_in_bits());
+    hash_node(hash, layout.child());
+    return hash;
+}
+
+uint64_t snapshot_checksum(const void *data, std::size_t size)
+{
+    /* Mix four independent lanes to not serialize on the latency of the multiplication. */
+    constexpr uint64_t K = 0x9e3779b97f4a7c15ULL;
+    uint64_t lanes[4] = { 1, 2, 3, 4 };
+    auto bytes = static_cast<const uint8_t*>(data);
+    std::size_t i = 0;
+    for (; i + 32 <= size; i += 32) {
+        for (std::size_t l = 0; l != 4; ++l) {
+            uint64_t word;
+            std::memcpy(&word, bytes + i + 8 * l, sizeof(word));
+            lanes[l] = std::rotl((lanes[l] ^ word) * K, 31);
+        }
+    }
+    uint64_t hash = FNV_OFFSET_BASIS;
+    for (uint64_t lane : lanes)
+        hash_value(hash, lane);
+    hash_bytes(hash, bytes + i, size - i);
+    hash_value(hash, size);
+    return hash;
+}
+
+std::size_t snapshot_data_size(const DataLayout &layout, std::size_t num_rows)
+{
+    const std::size_t tuples_per_block = layout.child().num_tuples();
+    const std::size_t num_blocks = (num_rows + tuples_per_block - 1) / tuples_per_block;
+    return num_blocks * (layout.stride_in_bits() / 8);
+}
+
+void write_snapshot(const std::filesystem::path &path, const Schema &schema, const DataLayout &layout,
+                    std::size_t num_rows, const void *memory)
+{
+    const std::string text = schema_text(schema);
+
+    snapshot_header header;
+    std::memcpy(header.magic, snapshot_header::MAGIC, sizeof(header.magic));
+    header.version = snapshot_header::VERSION;
+    header.num_attrs = schema.num_entries();
+    header.schema_fingerprint = schema_fingerprint(schema);
+    header.layout_fingerprint = layout_fingerprint(layout);
+    header.num_rows = num_rows;
+    header.schema_size = text.size();
+    header.data_offset = align_to_page(sizeof(header) + text.size());
+    header.data_size = snapshot_data_size(layout, num_rows);
+    header.checksum = snapshot_checksum(memory, header.data_size);
+
+    /* Pad the blocks to whole pages, such that they are read back from the page cache in whole pages. */
+    const std::string padding(header.data_offset - sizeof(header) - text.size(), '\0');
+    const std::string tail_padding(align_to_page(header.data_size) - header.data_size, '\0');
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (not out)
+        throw_errno("could not create", path);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out << text << padding;
+    out.write(static_cast<const char*>(memory), header.data_size);
+    out << tail_padding;
+    out.close();
+    if (not out)
+        throw_errno("could not write", path);
+}
+
+std::size_t read_snapshot(const std::filesystem::path &path, const Schema &schema, const DataLayout &layout,
+                          void *memory, std::size_t memory_size, bool verify_checksum)
+{
+    file_descriptor file(open(path.c_str(), O_RDONLY));
+    if (file.fd < 0)
+        throw_errno("could not open", path);
+
+    /* Reject files that are no snapshots of this schema in this layout. */
+    snapshot_header header;
+    if (not read_fully(file.fd, &header, sizeof(header), 0) or
+        std::memcmp(header.magic, snapshot_header::MAGIC, sizeof(header.magic)) != 0)
+        throw std::runtime_error(path.string() + " is not a snapshot");
+    if (header.version != snapshot_header::VERSION)
+        throw std::runtime_error(path.string() + " is a snapshot of version " + std::to_string(header.version) +
+                                 ", expected version " + std::to_string(snapshot_header::VERSION));
+    if (header.num_attrs != schema.num_entries() or header.schema_fingerprint != schema_fingerprint(schema))
+        throw std::runtime_error(path.string() + " is a snapshot of another schema");
+    if (header.layout_fingerprint != layout_fingerprint(layout))
+        throw std::runtime_error(path.string() + " is a snapshot in another data layout");
+    if (header.data_size != snapshot_data_size(layout, header.num_rows) or header.data_offset % page_size() != 0 or
+        std::filesystem::file_size(path) < header.data_offset + align_to_page(header.data_size))
+        throw std::runtime_error(path.string() + " is truncated");
+    if (header.data_size > memory_size)
+        throw std::runtime_error(path.string() + " does not fit into the store");
+
+    /* Copy the blocks into the memory rather than mapping the file over it, such that the pages of the store stay
+     * owned by its allocator. */
+    posix_fadvise(file.fd, header.data_offset, header.data_size, POSIX_FADV_SEQUENTIAL);
+    if (not read_fully(file.fd, memory, header.data_size, header.data_offset))
+        throw std::runtime_error(path.string() + " is truncated");
+
+    if (verify_checksum and snapshot_checksum(memory, header.data_size) != header.checksum) {
+        std::memset(memory, 0, header.data_size);
+        throw std::runtime_error(path.string() + " is corrupted");
+    }
+    return header.num_rows;
+}
+
+void write_snapshot(const Table &table, const std::filesystem::path &path)
+{
+    auto &store = table.store();
+    write_snapshot(path, table.schema(), table.layout(), store.num_rows(), store.memory().addr());
+}
+
+std::size_t open_snapshot(Table &table, const std::filesystem::path &path, bool verify_checksum)
+{
+    auto &store = table.store();
+    M_insist(store.num_rows() == 0, "snapshots can only be opened into empty tables");
+    const std::size_t num_rows = read_snapshot(path, table.schema(), table.layout(), store.memory().addr(),
+                                               store.memory().size(), verify_checksum);
+    /* The tuples are already in place, only make the store aware of them. */
+    for (std::size_t i = 0; i != num_rows; ++i)
+        store.append();
+    return num_rows;
+}
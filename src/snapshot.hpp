@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <mutable/mutable.hpp>
+
+
+/** The header of a snapshot file.  A snapshot persists the blocks of a loaded table as laid out in its store, such
+ * that a later run can read them back instead of parsing the CSV file again.  The header is followed by the names
+ * and types of the schema as text and, at the next page boundary, by the blocks. */
+struct snapshot_header
+{
+    static constexpr char MAGIC[8] = { 'D', 'B', 'S', 'Y', 'S', 'S', 'N', 'P' };
+    static constexpr uint32_t VERSION = 1;
+
+    char magic[8];
+    uint32_t version;
+    uint32_t num_attrs;
+    uint64_t schema_fingerprint; ///< see `schema_fingerprint()`
+    uint64_t layout_fingerprint; ///< see `layout_fingerprint()`
+    uint64_t num_rows;
+    uint64_t schema_size; ///< the size of the schema text in bytes
+    uint64_t data_offset; ///< the offset of the blocks in the file in bytes, a multiple of the page size
+    uint64_t data_size; ///< the size of the blocks in bytes
+    uint64_t checksum; ///< see `snapshot_checksum()`, computed over the blocks
+};
+
+/** Returns a hash of the names and types of the attributes of \p schema. */
+uint64_t schema_fingerprint(const m::Schema &schema);
+
+/** Returns a hash of the structure of \p layout, i.e. the number of tuples, offsets, and strides of all its nodes and
+ * the attribute and size of all its leaves.  Two layouts with the same fingerprint place every value at the same
+ * offset. */
+uint64_t layout_fingerprint(const m::storage::DataLayout &layout);
+
+/** Returns a checksum of the \p size bytes at \p data, processing 8 bytes at a time. */
+uint64_t snapshot_checksum(const void *data, std::size_t size);
+
+/** Returns the number of bytes of the blocks of \p layout that hold \p num_rows tuples. */
+std::size_t snapshot_data_size(const m::storage::DataLayout &layout, std::size_t num_rows);
+
+/** Writes the first \p num_rows tuples of \p schema, stored in \p layout at \p memory, to the snapshot file \p path.
+ * Throws `std::runtime_error` if the file cannot be written. */
+void write_snapshot(const std::filesystem::path &path, const m::Schema &schema, const m::storage::DataLayout &layout,
+                    std::size_t num_rows, const void *memory);
+
+/** Reads the blocks of the snapshot file \p path into the \p memory_size bytes at \p memory and returns the number of
+ * tuples of the snapshot.  Throws `std::runtime_error` if the file cannot be read, and if it is not a snapshot of
+ * \p schema in \p layout, was written by another version, or does not fit into \p memory.  If \p verify_checksum,
+ * corrupted snapshots are rejected as well, in which case the bytes read into \p memory are zeroed again. */
+std::size_t read_snapshot(const std::filesystem::path &path, const m::Schema &schema,
+                          const m::storage::DataLayout &layout, void *memory, std::size_t memory_size,
+                          bool verify_checksum = true);
+
+/** Writes the tuples of \p table to the snapshot file \p path. */
+void write_snapshot(const m::Table &table, const std::filesystem::path &path);
+
+/** Restores the tuples of \p table, which must be empty, from the snapshot file \p path.  The table's store and layout
+ * must be set.  Returns the number of tuples restored.  Throws `std::runtime_error` like `read_snapshot()`, in which
+ * case \p table is left empty. */
+std::size_t open_snapshot(m::Table &table, const std::filesystem::path &path, bool verify_checksum = true);
@@ -0,0 +1,178 @@
+#include "zone_maps.hpp"
+#include <algorithm>
+#include <cstring>
+#include <type_traits>
+
+
+using namespace m;
+using namespace m::storage;
+
+
+namespace {
+
+/** Reads a value of type \tparam T from the possibly unaligned address \p p. */
+template<typename T>
+T load(const uint8_t *p)
+{
+    T value;
+    std::memcpy(&value, p, sizeof(T));
+    return value;
+}
+
+/** Returns `true` iff values of \p type are summarized as `int64_t`, i.e. for integers, decimals, which are stored as
+ * scaled integers, and dates. */
+bool is_integer_like(const Type *type)
+{
+    return type->is_integral() or type->is_date() or
+           (type->is_numeric() and as<const Numeric>(type)->kind == Numeric::N_Decimal);
+}
+
+}
+
+ZoneMaps::ZoneMaps(const Schema &schema, const DataLayout &layout, void *memory)
+    : memory_(static_cast<uint8_t*>(memory))
+{
+    auto block = cast<const DataLayout::INode>(&layout.child());
+    M_insist(block, "zone maps require a PAX layout");
+    tuples_per_block_ = block->num_tuples();
+    block_size_in_bytes_ = layout.stride_in_bits() / 8;
+
+    std::size_t num_synopses = 0;
+    attrs_.resize(schema.num_entries());
+    for (std::size_t idx = 0; idx != schema.num_entries(); ++idx) {
+        attrs_[idx].type = schema[idx].type;
+        attrs_[idx].synopsis =
+            MyPAXZoneMapLayoutFactory::has_synopsis(schema[idx].type) ? num_synopses++ : NO_SYNOPSIS;
+    }
+
+    for (std::size_t i = 0; i != block->num_children(); ++i) {
+        auto &child = block->at(i);
+        auto leaf = cast<const DataLayout::Leaf>(child.ptr.get());
+        M_insist(leaf, "zone maps require a PAX layout");
+        if (leaf->index() == schema.num_entries()) {
+            bitmap_offset_in_bits_ = child.offset_in_bits;
+            bitmap_stride_in_bits_ = child.stride_in_bits;
+        } else {
+            attrs_[leaf->index()].offset_in_bits = child.offset_in_bits;
+            attrs_[leaf->index()].stride_in_bits = child.stride_in_bits;
+        }
+    }
+}
+
+const ZoneMaps::synopsis & ZoneMaps::at(std::size_t block, std::size_t attr) const
+{
+    M_insist(attrs_[attr].synopsis != NO_SYNOPSIS, "attribute has no synopsis");
+    return header(block)[attrs_[attr].synopsis];
+}
+
+bool ZoneMaps::is_null(std::size_t row, std::size_t attr) const
+{
+    const uint64_t bit = bitmap_offset_in_bits_ + (row % tuples_per_block_) * bitmap_stride_in_bits_ + attr;
+    return (*address(row, bit) >> (bit % 8)) & 1;
+}
+
+template<typename T>
+T ZoneMaps::get(std::size_t row, std::size_t attr) const
+{
+    auto &a = attrs_[attr];
+    auto p = address(row, a.offset_in_bits + (row % tuples_per_block_) * a.stride_in_bits);
+    if constexpr (std::is_same_v<T, double>) {
+        if (a.type->is_float())
+            return load<float>(p);
+        return load<double>(p);
+    } else {
+        switch (a.type->size()) {
+            case 8:  return load<int8_t>(p);
+            case 16: return load<int16_t>(p);
+            case 32: return load<int32_t>(p);
+            case 64: return load<int64_t>(p);
+            default: M_unreachable("unsupported integer size");
+        }
+    }
+}
+
+int64_t ZoneMaps::get_integer(std::size_t row, std::size_t attr) const
+{
+    M_insist(is_integer_like(attrs_[attr].type), "attribute must be integral");
+    return get<int64_t>(row, attr);
+}
+
+double ZoneMaps::get_double(std::size_t row, std::size_t attr) const
+{
+    M_insist(attrs_[attr].type->is_float() or attrs_[attr].type->is_double(), "attribute must be floating-point");
+    return get<double>(row, attr);
+}
+
+void ZoneMaps::update(std::size_t row)
+{
+    const std::size_t block = row / tuples_per_block_, num_before = row % tuples_per_block_;
+    for (std::size_t attr = 0; attr != attrs_.size(); ++attr) {
+        auto &a = attrs_[attr];
+        if (a.synopsis == NO_SYNOPSIS)
+            continue;
+
+        auto &s = header(block)[a.synopsis];
+        if (num_before == 0)
+            s.null_count = 0;
+        const bool first = s.null_count == num_before; // no non-NULL value seen in this block yet
+
+        if (is_null(row, attr)) {
+            ++s.null_count;
+        } else if (a.type->is_float() or a.type->is_double()) {
+            const double value = get<double>(row, attr);
+            s.min.d = first ? value : std::min(s.min.d, value);
+            s.max.d = first ? value : std::max(s.max.d, value);
+        } else {
+            const int64_t value = get<int64_t>(row, attr);
+            s.min.i = first ? value : std::min(s.min.i, value);
+            s.max.i = first ? value : std::max(s.max.i, value);
+        }
+    }
+}
+
+template<typename T>
+ZoneMaps::scan_stats ZoneMaps::scan(std::size_t attr, T lo, T hi, std::size_t num_rows,
+                                    const callback_type &callback) const
+{
+    scan_stats stats;
+    stats.num_blocks = num_blocks(num_rows);
+    for (std::size_t block = 0; block != stats.num_blocks; ++block) {
+        const std::size_t begin = block * tuples_per_block_;
+        const std::size_t end = std::min(begin + tuples_per_block_, num_rows);
+
+        /* Skip the block if all values are NULL or the range of its values does not intersect [lo, hi]. */
+        auto &s = at(block, attr);
+        T min, max;
+        if constexpr (std::is_same_v<T, double>)
+            min = s.min.d, max = s.max.d;
+        else
+            min = s.min.i, max = s.max.i;
+        if (s.null_count == end - begin or max < lo or min > hi) {
+            ++stats.num_skipped;
+            continue;
+        }
+
+        for (std::size_t row = begin; row != end; ++row) {
+            if (is_null(row, attr))
+                continue;
+            const T value = get<T>(row, attr);
+            if (lo <= value and value <= hi)
+                callback(row);
+        }
+    }
+    return stats;
+}
+
+ZoneMaps::scan_stats ZoneMaps::scan(std::size_t attr, int64_t lo, int64_t hi, std::size_t num_rows,
+                                    const callback_type &callback) const
+{
+    M_insist(is_integer_like(attrs_[attr].type), "attribute must be integral");
+    return scan<int64_t>(attr, lo, hi, num_rows, callback);
+}
+
+ZoneMaps::scan_stats ZoneMaps::scan(std::size_t attr, double lo, double hi, std::size_t num_rows,
+                                    const callback_type &callback) const
+{
+    M_insist(attrs_[attr].type->is_float() or attrs_[attr].type->is_double(), "attribute must be floating-point");
+    return scan<double>(attr, lo, hi, num_rows, callback);
+}
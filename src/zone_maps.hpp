@@ -0,0 +1,104 @@
+#pragma once
+
+#include "data_layouts.hpp"
+#include <cstdint>
+#include <functional>
+#include <mutable/mutable.hpp>
+#include <vector>
+
+
+/** Maintains and evaluates the per-block synopses of a table whose layout was computed by `MyPAXZoneMapLayoutFactory`.
+ * mutable does not know about the block headers holding the synopses, hence `update()` must be called for every tuple
+ * appended through a `m::StoreWriter`.  Integers, decimals, and dates are summarized as `int64_t`, decimals by their
+ * scaled integer representation, and floating-point numbers as `double`. */
+struct ZoneMaps
+{
+    /** The synopsis of one attribute in one block, as stored in the block header. */
+    struct synopsis
+    {
+        union value_t { int64_t i; double d; };
+
+        value_t min; ///< the minimum of the non-NULL values
+        value_t max; ///< the maximum of the non-NULL values
+        uint64_t null_count;
+    };
+    static_assert(sizeof(synopsis) * 8 == MyPAXZoneMapLayoutFactory::SYNOPSIS_SIZE_IN_BITS);
+
+    /** Statistics of a scan. */
+    struct scan_stats
+    {
+        std::size_t num_blocks = 0; ///< the number of blocks of the scanned rows
+        std::size_t num_skipped = 0; ///< the number of blocks skipped due to their synopsis
+    };
+
+    using callback_type = std::function<void(std::size_t)>;
+
+    private:
+    static constexpr std::size_t NO_SYNOPSIS = -1;
+
+    struct attribute
+    {
+        const m::Type *type;
+        uint64_t offset_in_bits; ///< the offset of the minipage within a block
+        uint64_t stride_in_bits;
+        std::size_t synopsis; ///< the index of the synopsis in the block header, or `NO_SYNOPSIS`
+    };
+
+    std::vector<attribute> attrs_;
+    uint64_t bitmap_offset_in_bits_ = 0;
+    uint64_t bitmap_stride_in_bits_ = 0;
+    std::size_t tuples_per_block_;
+    uint64_t block_size_in_bytes_;
+    uint8_t *memory_;
+
+    public:
+    /** Creates zone maps for tuples of \p schema stored in \p layout at \p memory. */
+    ZoneMaps(const m::Schema &schema, const m::storage::DataLayout &layout, void *memory);
+    /** Creates zone maps for the tuples in the store of \p table. */
+    explicit ZoneMaps(const m::Table &table)
+        : ZoneMaps(table.schema(), table.layout(), table.store().memory().addr())
+    { }
+
+    std::size_t tuples_per_block() const { return tuples_per_block_; }
+    std::size_t num_blocks(std::size_t num_rows) const {
+        return (num_rows + tuples_per_block_ - 1) / tuples_per_block_;
+    }
+
+    /** Returns the synopsis of attribute \p attr in block \p block. */
+    const synopsis & at(std::size_t block, std::size_t attr) const;
+
+    /** Includes the values of \p row in the synopses of its block.  Rows must be updated in the order they are
+     * appended. */
+    void update(std::size_t row);
+
+    /** Returns `true` iff attribute \p attr of \p row is NULL. */
+    bool is_null(std::size_t row, std::size_t attr) const;
+    /** Returns the value of the integral, decimal, or date attribute \p attr of \p row.  Decimals are returned scaled
+     * to integers. */
+    int64_t get_integer(std::size_t row, std::size_t attr) const;
+    /** Returns the value of the floating-point attribute \p attr of \p row. */
+    double get_double(std::size_t row, std::size_t attr) const;
+
+    /** Calls \p callback with the index of every row among the first \p num_rows rows whose value of the integral,
+     * decimal, or date attribute \p attr is within the closed interval [\p lo, \p hi].  Blocks whose synopsis rules out
+     * the interval are skipped.  For decimals, \p lo and \p hi are scaled to integers like the values. */
+    scan_stats scan(std::size_t attr, int64_t lo, int64_t hi, std::size_t num_rows,
+                    const callback_type &callback) const;
+    /** Like the integral `scan()`, for the floating-point attribute \p attr. */
+    scan_stats scan(std::size_t attr, double lo, double hi, std::size_t num_rows, const callback_type &callback) const;
+
+    private:
+    /** Returns the header of \p block, i.e. its array of synopses. */
+    synopsis * header(std::size_t block) const {
+        return reinterpret_cast<synopsis*>(memory_ + block * block_size_in_bytes_);
+    }
+    /** Returns the address of the byte containing bit \p offset_in_bits of the block of \p row. */
+    const uint8_t * address(std::size_t row, uint64_t offset_in_bits) const {
+        return memory_ + (row / tuples_per_block_) * block_size_in_bytes_ + offset_in_bits / 8;
+    }
+    /** Returns the value of \p attr of \p row, summarized as \tparam T. */
+    template<typename T>
+    T get(std::size_t row, std::size_t attr) const;
+    template<typename T>
+    scan_stats scan(std::size_t attr, T lo, T hi, std::size_t num_rows, const callback_type &callback) const;
+};
@@ -1,7 +1,13 @@
 #include "catch2/catch.hpp"
 
 #include "BTree.hpp"
+#include <algorithm>
 #include <array>
+#include <limits>
+#include <map>
+#include <numeric>
+#include <random>
+#include <thread>
 #include <typeinfo>
 #include <vector>
 
@@ -683,8 +689,356 @@ void __test_equal_range()
     }
 }
 
+template<typename key_type, typename value_type, std::size_t node_size>
+void __test_node_search()
+{
+    using tree_type = BTree<key_type, value_type, node_size>;
+    using limits = std::numeric_limits<key_type>;
+
+    /* Keys with duplicates, spread over the whole domain, including its extremes and, for unsigned keys, the values
+     * that differ in the most significant bit only. */
+    std::mt19937 g(42);
+    std::vector<key_type> keys = { limits::min(), limits::max(), key_type(0), key_type(-1), key_type(1),
+                                   key_type(limits::max() / 2), key_type(limits::max() / 2 + 1) };
+    std::uniform_int_distribution<key_type> dist(limits::min(), limits::max());
+    while (keys.size() != 3000)
+        keys.push_back(keys.size() % 3 ? dist(g) : keys[keys.size() / 2]);
+    std::sort(keys.begin(), keys.end());
+
+    std::vector<std::pair<key_type, value_type>> data;
+    for (std::size_t i = 0; i != keys.size(); ++i)
+        data.emplace_back(keys[i], i);
+    auto tree = tree_type::Bulkload(data.cbegin(), data.cend());
+
+    /* Returns the position of `it` in `tree`, i.e. the value of the pair it points to. */
+    auto position = [&](auto it) { return it == tree.cend() ? keys.size() : std::size_t((*it).second()); };
+
+    std::vector<key_type> probes = keys;
+    for (std::size_t i = 0; i != 1000; ++i)
+        probes.push_back(dist(g));
+    for (key_type key : probes) {
+        const std::size_t lower = std::lower_bound(keys.begin(), keys.end(), key) - keys.begin();
+        const std::size_t upper = std::upper_bound(keys.begin(), keys.end(), key) - keys.begin();
+        auto range = tree.equal_range(key);
+        REQUIRE(position(range.begin()) == lower);
+        REQUIRE(position(range.end()) == upper);
+        CHECK(position(tree.find(key)) == (lower == upper ? keys.size() : lower));
+    }
 }
 
+template<typename key_type, typename value_type, std::size_t node_size>
+void __test_concurrent_lookups()
+{
+    using tree_type = BTree<key_type, value_type, node_size>;
+    using pair_type = std::pair<key_type, value_type>;
+
+    /* Even keys 0, 2, ..., 2 * (N - 1), each twice, with values 2 * key and 2 * key + 1. */
+    constexpr key_type N = 5000;
+    std::vector<pair_type> data;
+    for (key_type i = 0; i != N; ++i) {
+        data.emplace_back(2 * i, 4 * i);
+        data.emplace_back(2 * i, 4 * i + 1);
+    }
+    auto tree = tree_type::Bulkload(data.cbegin(), data.cend());
+    const tree_type &ctree = tree;
+
+    SECTION("const lookups")
+    {
+        for (key_type key = -1; key <= 2 * N; ++key) {
+            const bool present = key >= 0 and key < 2 * N and key % 2 == 0;
+
+            auto it = ctree.find(key);
+            if (present) {
+                REQUIRE(it != ctree.cend());
+                CHECK((*it).first() == key);
+                CHECK((*it).second() == 2 * key);
+            } else {
+                CHECK(it == ctree.cend());
+            }
+
+            auto equal = ctree.equal_range(key);
+            unsigned count = 0;
+            for (auto it = equal.begin(); it != equal.end(); ++it, ++count)
+                CHECK((*it).first() == key);
+            CHECK(count == (present ? 2 : 0));
+        }
+
+        auto range = ctree.find_range(11, 21);
+        unsigned count = 0;
+        for (auto it = range.begin(); it != range.end(); ++it, ++count)
+            CHECK((*it).first() == 12 + 2 * key_type(count / 2));
+        CHECK(count == 10);
+
+        CHECK(ctree.find_range(21, 11).empty());
+        CHECK(ctree.find_range(2 * N, 3 * N).empty());
+    }
+
+    SECTION("concurrent readers")
+    {
+        /* Every reader looks up all keys, starting at a different offset, and counts the values it finds correct.  The
+         * lookups must not interfere, i.e. every reader must find every key. */
+        constexpr unsigned NUM_THREADS = 8;
+        std::vector<std::size_t> num_correct(NUM_THREADS, 0);
+        std::vector<std::thread> threads;
+        for (unsigned t = 0; t != NUM_THREADS; ++t) {
+            threads.emplace_back([&ctree, &num_correct, t]() {
+                std::size_t correct = 0;
+                for (int round = 0; round != 10; ++round) {
+                    for (key_type i = 0; i != N; ++i) {
+                        const key_type key = 2 * ((i + t * N / NUM_THREADS) % N);
+                        auto it = ctree.find(key);
+                        auto range = ctree.equal_range(key);
+                        if (it != ctree.cend() and (*it).second() == 2 * key and range.begin() == it)
+                            ++correct;
+                    }
+                }
+                num_correct[t] = correct;
+            });
+        }
+        for (auto &thread : threads)
+            thread.join();
+        for (unsigned t = 0; t != NUM_THREADS; ++t)
+            CHECK(num_correct[t] == 10 * std::size_t(N));
+    }
+}
+
+template<typename key_type, typename value_type, std::size_t node_size>
+void __test_find_batch()
+{
+    using tree_type = BTree<key_type, value_type, node_size>;
+    using pair_type = std::pair<key_type, value_type>;
+
+    SECTION("empty")
+    {
+        std::array<pair_type, 0> data;
+        const auto tree = tree_type::Bulkload(data.cbegin(), data.cend());
+        const std::vector<key_type> keys = { 0, 42 };
+        std::vector<typename tree_type::const_iterator> out(keys.size());
+        tree.find_batch(keys, out);
+        CHECK(out[0] == tree.cend());
+        CHECK(out[1] == tree.cend());
+    }
+
+    SECTION("hits and misses")
+    {
+        /* Even keys 0, 2, ..., with some repetitions, and lookups of even and odd keys, and keys beyond the last. */
+        std::vector<pair_type> data;
+        for (key_type i = 0; i != 5000; ++i) {
+            for (key_type rep = 0; rep != 1 + (i % 7 == 0); ++rep)
+                data.emplace_back(2 * i, 3 * i + rep);
+        }
+        auto tree = tree_type::Bulkload(data.cbegin(), data.cend());
+        const tree_type &ctree = tree;
+
+        std::mt19937 g(13);
+        std::uniform_int_distribution<key_type> dist(-10, 10010);
+        for (std::size_t num_keys : { 0UL, 1UL, 7UL, tree_type::FIND_BATCH_SIZE, 3 * tree_type::FIND_BATCH_SIZE + 5 }) {
+            std::vector<key_type> keys(num_keys);
+            std::generate(keys.begin(), keys.end(), [&]() { return dist(g); });
+
+            std::vector<typename tree_type::const_iterator> out(num_keys);
+            ctree.find_batch(keys, out);
+            std::vector<typename tree_type::iterator> mutable_out(num_keys);
+            tree.find_batch(keys, mutable_out);
+            for (std::size_t i = 0; i != num_keys; ++i) {
+                CHECK(out[i] == ctree.find(keys[i]));
+                CHECK(mutable_out[i] == tree.find(keys[i]));
+            }
+        }
+    }
+}
+
+template<typename key_type, typename value_type, std::size_t node_size>
+void __test_insert_erase()
+{
+    using tree_type = BTree<key_type, value_type, node_size>;
+    using pair_type = std::pair<key_type, value_type>;
+
+    /* Checks that iterating `tree` yields exactly the pairs of `expected`, in order. */
+    auto check_contents = [](const tree_type &tree, const std::multimap<key_type, value_type> &expected) {
+        REQUIRE(tree.size() == expected.size());
+        auto it = tree.cbegin();
+        for (auto &[key, value] : expected) {
+            REQUIRE(it != tree.cend());
+            CHECK((*it).first() == key);
+            CHECK((*it).second() == value);
+            ++it;
+        }
+        CHECK(it == tree.cend());
+    };
+
+    SECTION("insert into empty tree")
+    {
+        constexpr key_type N = 2000;
+        std::vector<key_type> keys(N);
+        std::iota(keys.begin(), keys.end(), 0);
+        std::shuffle(keys.begin(), keys.end(), std::mt19937(42));
+
+        std::array<pair_type, 0> data;
+        auto tree = tree_type::Bulkload(data.cbegin(), data.cend());
+        std::multimap<key_type, value_type> expected;
+        for (key_type key : keys) {
+            auto it = tree.insert(key, 2 * key + 13);
+            REQUIRE(it != tree.end());
+            CHECK((*it).first() == key);
+            CHECK((*it).second() == 2 * key + 13);
+            expected.emplace(key, 2 * key + 13);
+        }
+        check_contents(tree, expected);
+        CHECK(tree.height() > 0);
+
+        for (key_type key = 0; key != N; ++key) {
+            auto it = tree.find(key);
+            REQUIRE(it != tree.end());
+            CHECK((*it).second() == 2 * key + 13);
+        }
+        CHECK(tree.find(N) == tree.end());
+    }
+
+    SECTION("insert into bulkloaded tree")
+    {
+        constexpr key_type N = 1000;
+        std::vector<pair_type> data;
+        std::multimap<key_type, value_type> expected;
+        for (key_type key = 0; key != N; ++key) {
+            data.emplace_back(2 * key, key);
+            expected.emplace(2 * key, key);
+        }
+        auto tree = tree_type::Bulkload(data.cbegin(), data.cend());
+
+        /* Insert the odd keys in between and duplicates behind the existing keys. */
+        for (key_type key = N - 1; key >= 0; --key) {
+            tree.insert(2 * key + 1, key);
+            expected.emplace(2 * key + 1, key);
+        }
+        for (key_type key = 0; key < 2 * N; key += 7) {
+            tree.insert(key, -1);
+            expected.emplace(key, -1);
+        }
+        check_contents(tree, expected);
+
+        auto range = tree.equal_range(14);
+        auto it = range.begin();
+        REQUIRE(it != range.end());
+        CHECK((*it).second() == 7);
+        ++it;
+        REQUIRE(it != range.end());
+        CHECK((*it).second() == -1);
+        ++it;
+        CHECK(it == range.end());
+    }
+
+    SECTION("insert_or_assign")
+    {
+        constexpr key_type N = 100;
+        std::vector<pair_type> data;
+        for (key_type key = 0; key != N; ++key)
+            data.emplace_back(key, 2 * key + 13);
+        auto tree = tree_type::Bulkload(data.cbegin(), data.cend());
+
+        {
+            auto [it, inserted] = tree.insert_or_assign(42, 1);
+            CHECK_FALSE(inserted);
+            CHECK((*it).first() == 42);
+            CHECK((*it).second() == 1);
+            CHECK(tree.size() == N);
+            CHECK((*tree.find(42)).second() == 1);
+        }
+
+        {
+            auto [it, inserted] = tree.insert_or_assign(N, 1);
+            CHECK(inserted);
+            CHECK((*it).first() == N);
+            CHECK(tree.size() == N + 1);
+        }
+
+        {
+            auto [it, inserted] = tree.insert_or_assign(-1, 1);
+            CHECK(inserted);
+            CHECK(it == tree.begin());
+        }
+    }
+
+    SECTION("erase")
+    {
+        constexpr key_type N = 2000;
+        std::vector<pair_type> data;
+        std::multimap<key_type, value_type> expected;
+        for (key_type key = 0; key != N; ++key) {
+            data.emplace_back(key, 2 * key + 13);
+            expected.emplace(key, 2 * key + 13);
+        }
+        auto tree = tree_type::Bulkload(data.cbegin(), data.cend());
+
+        std::vector<key_type> keys(N);
+        std::iota(keys.begin(), keys.end(), 0);
+        std::shuffle(keys.begin(), keys.end(), std::mt19937(42));
+        for (std::size_t i = 0; i != keys.size(); ++i) {
+            CHECK(tree.erase(keys[i]) == 1);
+            CHECK(tree.erase(keys[i]) == 0);
+            expected.erase(keys[i]);
+            if (i % 97 == 0)
+                check_contents(tree, expected);
+        }
+
+        CHECK(tree.size() == 0);
+        CHECK(tree.height() == 0);
+        CHECK(tree.begin() == tree.end());
+        CHECK(tree.find(0) == tree.end());
+
+        /* The tree is usable after erasing everything. */
+        tree.insert(42, 13);
+        REQUIRE(tree.begin() != tree.end());
+        CHECK((*tree.begin()).first() == 42);
+    }
+
+    SECTION("erase duplicates")
+    {
+        constexpr key_type n = 500;
+        constexpr unsigned REP_COUNT = 4;
+        std::vector<pair_type> data;
+        for (key_type key = 0; key != n; ++key) {
+            for (key_type v = 0; v != REP_COUNT; ++v)
+                data.emplace_back(key, v);
+        }
+        auto tree = tree_type::Bulkload(data.cbegin(), data.cend());
+
+        for (key_type key = 0; key < n; key += 3) {
+            CHECK(tree.erase(key) == REP_COUNT);
+            CHECK(tree.equal_range(key).empty());
+        }
+        CHECK(tree.size() == (n - (n + 2) / 3) * REP_COUNT);
+        unsigned count = 0;
+        for (auto it = tree.equal_range(1).begin(), end = tree.equal_range(1).end(); it != end; ++it)
+            ++count;
+        CHECK(count == REP_COUNT);
+    }
+
+    SECTION("random inserts and erases")
+    {
+        std::mt19937 g(0);
+        std::uniform_int_distribution<key_type> dist_key(0, 500);
+        std::array<pair_type, 0> data;
+        auto tree = tree_type::Bulkload(data.cbegin(), data.cend());
+        std::multimap<key_type, value_type> expected;
+        for (int i = 0; i != 20000; ++i) {
+            const key_type key = dist_key(g);
+            if (g() % 3) {
+                tree.insert(key, i);
+                expected.emplace(key, i);
+            } else {
+                CHECK(tree.erase(key) == expected.erase(key));
+            }
+            if (i % 1000 == 0)
+                check_contents(tree, expected);
+        }
+        check_contents(tree, expected);
+    }
+}
+
+}
+
+
 
 
 TEST_CASE("BTree/node size", "[milestone2]")
@@ -715,6 +1069,19 @@ TEST_CASE("BTree/node size", "[milestone2]")
     TEST(int32_t, int64_t, 512);
     TEST(int64_t, int64_t, 512);
 #undef TEST
+
+    SECTION("capacity of 64B nodes")
+    {
+        /* A node spends only a 4 byte header, plus the `next` pointer of a leaf, on bookkeeping. */
+        CHECK(BTree<int32_t, int32_t, 64>::NUM_KEYS_PER_LEAF == 6);
+        CHECK(BTree<int32_t, int32_t, 64>::NUM_KEYS_PER_INODE == 5);
+        CHECK(BTree<int64_t, int32_t, 64>::NUM_KEYS_PER_LEAF == 4);
+        CHECK(BTree<int64_t, int32_t, 64>::NUM_KEYS_PER_INODE == 3);
+        CHECK(BTree<int32_t, int64_t, 64>::NUM_KEYS_PER_LEAF == 4);
+        CHECK(BTree<int32_t, int64_t, 64>::NUM_KEYS_PER_INODE == 5);
+        CHECK(BTree<int64_t, int64_t, 64>::NUM_KEYS_PER_LEAF == 3);
+        CHECK(BTree<int64_t, int64_t, 64>::NUM_KEYS_PER_INODE == 3);
+    }
 }
 
 TEST_CASE("BTree/Bulkload", "[milestone2]")
@@ -776,3 +1143,76 @@ TEST_CASE("BTree/equal_range", "[milestone2]")
 
 #undef TEST
 }
+
+TEST_CASE("BTree/insert_erase", "[milestone2]")
+{
+#define TEST(KEY, VALUE, NODE_SIZE) \
+    DYNAMIC_SECTION((#KEY " -> " #VALUE ", " #NODE_SIZE "B")) \
+    { __test_insert_erase<KEY, VALUE, NODE_SIZE>(); }
+
+    TEST(int32_t, int32_t, 4096);
+    TEST(int64_t, int64_t, 4096);
+
+    TEST(int32_t, int32_t, 512);
+    TEST(int64_t, int64_t, 512);
+
+    TEST(int32_t, int32_t, 64);
+    TEST(int64_t, int64_t, 64);
+
+#undef TEST
+}
+
+TEST_CASE("BTree/node search", "[milestone2]")
+{
+#define TEST(KEY, VALUE, NODE_SIZE) \
+    DYNAMIC_SECTION((#KEY " -> " #VALUE ", " #NODE_SIZE "B")) \
+    { __test_node_search<KEY, VALUE, NODE_SIZE>(); }
+
+    TEST(int32_t, uint32_t, 4096);
+    TEST(uint32_t, uint32_t, 4096);
+    TEST(int64_t, uint32_t, 4096);
+    TEST(uint64_t, uint32_t, 4096);
+
+    TEST(int32_t, uint32_t, 512);
+    TEST(uint32_t, uint32_t, 512);
+    TEST(int64_t, uint32_t, 512);
+    TEST(uint64_t, uint32_t, 512);
+
+    TEST(int32_t, uint32_t, 64);
+    TEST(uint64_t, uint32_t, 64);
+
+#undef TEST
+}
+
+TEST_CASE("BTree/concurrent_lookups", "[milestone2]")
+{
+#define TEST(KEY, VALUE, NODE_SIZE) \
+    DYNAMIC_SECTION((#KEY " -> " #VALUE ", " #NODE_SIZE "B")) \
+    { __test_concurrent_lookups<KEY, VALUE, NODE_SIZE>(); }
+
+    TEST(int32_t, int32_t, 4096);
+    TEST(int64_t, int64_t, 4096);
+
+    TEST(int32_t, int32_t, 64);
+    TEST(int64_t, int64_t, 64);
+
+#undef TEST
+}
+
+TEST_CASE("BTree/find_batch", "[milestone2]")
+{
+#define TEST(KEY, VALUE, NODE_SIZE) \
+    DYNAMIC_SECTION((#KEY " -> " #VALUE ", " #NODE_SIZE "B")) \
+    { __test_find_batch<KEY, VALUE, NODE_SIZE>(); }
+
+    TEST(int32_t, int32_t, 4096);
+    TEST(int64_t, int64_t, 4096);
+
+    TEST(int32_t, int32_t, 512);
+    TEST(int64_t, int64_t, 512);
+
+    TEST(int32_t, int32_t, 64);
+    TEST(int64_t, int64_t, 64);
+
+#undef TEST
+}
@@ -0,0 +1,113 @@
+#include <catch2/catch.hpp>
+
+#include "column_writer.hpp"
+#include "data_layouts.hpp"
+#include <cstring>
+#include <string>
+#include <vector>
+
+
+using namespace m;
+using namespace m::storage;
+
+
+TEST_CASE("write_columns", "[milestone1]")
+{
+    Catalog::Clear(); // drop all data
+    auto &C = m::Catalog::Get();
+
+    auto &DB = C.add_database(C.pool("test_db"));
+    auto &table = DB.add_table(C.pool("test"));
+    table.push_back(C.pool("a_i4"), m::Type::Get_Integer(m::Type::TY_Vector, 4));
+    table.push_back(C.pool("b_b"),  m::Type::Get_Boolean(m::Type::TY_Vector));
+    table.push_back(C.pool("c_c3"), m::Type::Get_Char(m::Type::TY_Vector, 3));
+    table.push_back(C.pool("d_i8"), m::Type::Get_Integer(m::Type::TY_Vector, 8));
+    table.push_back(C.pool("e_i2"), m::Type::Get_Integer(m::Type::TY_Vector, 2));
+
+    std::vector<std::pair<const char*, std::unique_ptr<DataLayoutFactory>>> factories;
+    factories.emplace_back("row_naive", std::make_unique<MyNaiveRowLayoutFactory>());
+    factories.emplace_back("row_optimized", std::make_unique<MyOptimizedRowLayoutFactory>());
+    factories.emplace_back("row_packed", std::make_unique<MyPackedRowLayoutFactory>());
+    factories.emplace_back("row_cache_aligned", std::make_unique<MyCacheAlignedRowLayoutFactory>());
+    factories.emplace_back("PAX", std::make_unique<MyPAXLayoutFactory>(512));
+    factories.emplace_back("DSM", std::make_unique<MyDSMLayoutFactory>());
+    factories.emplace_back("hybrid", std::make_unique<MyHybridLayoutFactory>(std::vector<double>{ 1., 0., 1., 0., 0. }));
+
+    /* Tuple `i` is (i, i % 3 == 0, "xyz" shifted by i, -i, i), where `d_i8` is NULL in every fifth tuple. */
+    const std::size_t num_rows = 3000;
+    std::vector<int32_t> a(num_rows);
+    std::unique_ptr<bool[]> b(new bool[num_rows]);
+    std::vector<char> c(3 * num_rows);
+    std::vector<int64_t> d(num_rows);
+    std::vector<int16_t> e(num_rows);
+    std::vector<uint8_t> d_nulls((num_rows + 7) / 8);
+    for (std::size_t i = 0; i != num_rows; ++i) {
+        a[i] = i;
+        b[i] = i % 3 == 0;
+        for (std::size_t j = 0; j != 3; ++j)
+            c[3 * i + j] = 'x' + (i + j) % 3;
+        d[i] = -int64_t(i);
+        e[i] = i;
+        if (i % 5 == 0)
+            d_nulls[i / 8] |= 1 << (i % 8);
+    }
+    const std::vector<column_batch> columns = {
+        { a.data() }, { b.get() }, { c.data() }, { d.data(), d_nulls.data() }, { e.data() }
+    };
+
+    for (auto &[name, factory] : factories) {
+        DYNAMIC_SECTION(name)
+        {
+            auto layout = factory->make(table.schema());
+            const std::size_t tuples_per_block = layout.child().num_tuples();
+            const std::size_t num_blocks = (num_rows + 7 + tuples_per_block - 1) / tuples_per_block;
+            std::vector<uint64_t> memory(num_blocks * layout.stride_in_bits() / 64 + 1, ~uint64_t(0));
+            auto bytes = reinterpret_cast<const uint8_t*>(memory.data());
+            auto bit = [&](std::size_t row, std::size_t attr) {
+                const uint64_t offset = attribute_offset_in_bits(layout, row, attr);
+                return bool((bytes[offset / 8] >> (offset % 8)) & 1);
+            };
+            auto is_null = [&](std::size_t row, std::size_t attr) {
+                const uint64_t offset = attribute_offset_in_bits(layout, row, 5) + attr;
+                return bool((bytes[offset / 8] >> (offset % 8)) & 1);
+            };
+
+            /* Write at an offset that is not aligned to blocks. */
+            const std::size_t first_row = 7;
+            write_columns(table.schema(), layout, memory.data(), first_row, num_rows, columns);
+
+            for (std::size_t i = 0; i != num_rows; ++i) {
+                const std::size_t row = first_row + i;
+                int32_t a_value;
+                std::memcpy(&a_value, bytes + attribute_offset_in_bits(layout, row, 0) / 8, sizeof(a_value));
+                REQUIRE(a_value == a[i]);
+                REQUIRE(bit(row, 1) == b[i]);
+                REQUIRE(std::memcmp(bytes + attribute_offset_in_bits(layout, row, 2) / 8, &c[3 * i], 3) == 0);
+                int16_t e_value;
+                std::memcpy(&e_value, bytes + attribute_offset_in_bits(layout, row, 4) / 8, sizeof(e_value));
+                REQUIRE(e_value == e[i]);
+
+                /* NULL bitmap */
+                REQUIRE(is_null(row, 3) == (i % 5 == 0));
+                for (std::size_t attr : { 0, 1, 2, 4 })
+                    REQUIRE_FALSE(is_null(row, attr));
+                if (i % 5) {
+                    int64_t d_value;
+                    std::memcpy(&d_value, bytes + attribute_offset_in_bits(layout, row, 3) / 8, sizeof(d_value));
+                    REQUIRE(d_value == d[i]);
+                }
+            }
+        }
+    }
+
+    SECTION("invalid batches")
+    {
+        std::unique_ptr<DataLayoutFactory> factory = std::make_unique<MyOptimizedRowLayoutFactory>(false);
+        auto layout = factory->make(table.schema());
+        std::vector<uint64_t> memory(num_rows * layout.stride_in_bits() / 64 + 1);
+        CHECK_THROWS_AS(write_columns(table.schema(), layout, memory.data(), 0, num_rows, { columns[0] }),
+                        std::invalid_argument);
+        CHECK_THROWS_AS(write_columns(table.schema(), layout, memory.data(), 0, num_rows, columns),
+                        std::invalid_argument);
+    }
+}
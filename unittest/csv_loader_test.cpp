@@ -0,0 +1,260 @@
+#include <catch2/catch.hpp>
+
+#include "csv_loader.hpp"
+#include "csv_tokenizer.hpp"
+#include <cstring>
+#include <string>
+#include <vector>
+
+
+using namespace m;
+using namespace m::storage;
+
+
+TEST_CASE("split_CSV", "[milestone1]")
+{
+    const std::string csv = "1,\"a\nb\",x\n"
+                            "2,\"\"\"quoted\"\"\n\",y\n"
+                            "3,plain,z\n"
+                            "4,\"c,\nd\",w";
+    const char *begin = csv.data(), *end = csv.data() + csv.size();
+
+    for (std::size_t num_chunks = 1; num_chunks != csv.size() + 2; ++num_chunks) {
+        auto chunks = split_CSV(begin, end, num_chunks);
+        REQUIRE(not chunks.empty());
+        REQUIRE(chunks.size() <= num_chunks);
+        REQUIRE(chunks.front().begin == begin);
+        REQUIRE(chunks.back().end == end);
+
+        /* Chunks are contiguous, end at record boundaries, and contain 4 records in total. */
+        std::size_t num_records = 0;
+        for (std::size_t i = 0; i != chunks.size(); ++i) {
+            if (i != 0)
+                REQUIRE(chunks[i].begin == chunks[i - 1].end);
+            if (chunks[i].end != end) {
+                REQUIRE(chunks[i].end[-1] == '\n');
+                REQUIRE((chunks[i].end[0] >= '1' and chunks[i].end[0] <= '4'));
+            }
+            num_records += count_CSV_records(chunks[i]);
+        }
+        REQUIRE(num_records == 4);
+    }
+
+    CHECK(split_CSV(begin, begin, 4).empty());
+}
+
+TEST_CASE("CSV_tokenizer", "[milestone1]")
+{
+    /* Build records whose quoted fields, escaped quotes, and newlines straddle the 64 byte blocks of the tokenizer. */
+    std::vector<std::vector<std::string>> records;
+    std::string csv;
+    for (std::size_t i = 0; i != 50; ++i) {
+        std::vector<std::string> record{
+            std::to_string(i),
+            "\"" + std::string(i, ',') + "\"\"\n" + std::string(i % 7, 'x') + "\"",
+            std::string(i % 13, 'y'),
+        };
+        for (std::size_t j = 0; j != record.size(); ++j)
+            csv += (j ? "," : "") + record[j];
+        csv += '\n';
+        records.push_back(std::move(record));
+    }
+
+    CSV_tokenizer tokenizer(csv.data(), csv.data() + csv.size());
+    for (auto &record : records) {
+        for (std::size_t j = 0; j != record.size(); ++j) {
+            REQUIRE(tokenizer.has_next());
+            auto field = tokenizer.next();
+            REQUIRE(field.data == record[j]);
+            REQUIRE(field.is_last == (j + 1 == record.size()));
+        }
+    }
+    CHECK_FALSE(tokenizer.has_next());
+
+    SECTION("escaped quotes")
+    {
+        /* Runs of backslashes of both parities in front of quotes, delimiters, and newlines, straddling blocks. */
+        std::vector<std::vector<std::string>> records;
+        std::string csv;
+        for (std::size_t i = 0; i != 50; ++i) {
+            const std::string even(2 * (i % 3), '\\'), odd(2 * (i % 4) + 1, '\\');
+            std::vector<std::string> record{
+                std::to_string(i),
+                "\"" + even + odd + "\"" + std::string(i, ',') + odd + "\"\n" + even + "\"",
+                even + std::string(i % 5, 'y') + odd,
+            };
+            for (std::size_t j = 0; j != record.size(); ++j)
+                csv += (j ? "," : "") + record[j];
+            csv += '\n';
+            records.push_back(std::move(record));
+        }
+
+        CSV_tokenizer tokenizer(csv.data(), csv.data() + csv.size());
+        for (auto &record : records) {
+            for (std::size_t j = 0; j != record.size(); ++j) {
+                REQUIRE(tokenizer.has_next());
+                auto field = tokenizer.next();
+                REQUIRE(field.data == record[j]);
+                REQUIRE(field.is_last == (j + 1 == record.size()));
+            }
+        }
+        CHECK_FALSE(tokenizer.has_next());
+    }
+
+    SECTION("without trailing newline")
+    {
+        const std::string csv = "a,\"b\nc\"";
+        CSV_tokenizer tokenizer(csv.data(), csv.data() + csv.size());
+        CHECK(tokenizer.next().data == "a");
+        auto field = tokenizer.next();
+        CHECK(field.data == "\"b\nc\"");
+        CHECK(field.is_last);
+        CHECK_FALSE(tokenizer.has_next());
+    }
+}
+
+TEST_CASE("parse_CSV_records", "[milestone1]")
+{
+    const bool vectorized = GENERATE(false, true);
+    Catalog::Clear(); // drop all data
+    auto &C = m::Catalog::Get();
+
+    auto &DB = C.add_database(C.pool("test_db"));
+    auto &table = DB.add_table(C.pool("test"));
+    table.push_back(C.pool("a_i4"), m::Type::Get_Integer(m::Type::TY_Vector, 4));
+    table.push_back(C.pool("b_c5"), m::Type::Get_Char(m::Type::TY_Vector, 5));
+    table.push_back(C.pool("c_b"),  m::Type::Get_Boolean(m::Type::TY_Vector));
+    table.push_back(C.pool("d_d"),  m::Type::Get_Double(m::Type::TY_Vector));
+
+    std::unique_ptr<DataLayoutFactory> factory = std::make_unique<MyPAX4kLayoutFactory>();
+    auto layout = factory->make(table.schema());
+    std::vector<uint64_t> memory(2 * 4096 / sizeof(uint64_t));
+    auto bytes = reinterpret_cast<const uint8_t*>(memory.data());
+
+    auto value = [&](std::size_t row, std::size_t attr) {
+        return bytes + attribute_offset_in_bits(layout, row, attr) / 8;
+    };
+    auto bit = [&](std::size_t row, std::size_t attr) {
+        const uint64_t offset = attribute_offset_in_bits(layout, row, attr);
+        return bool((bytes[offset / 8] >> (offset % 8)) & 1);
+    };
+    auto is_null = [&](std::size_t row, std::size_t attr) {
+        const uint64_t offset = attribute_offset_in_bits(layout, row, 4) + attr;
+        return bool((bytes[offset / 8] >> (offset % 8)) & 1);
+    };
+
+    const std::string csv = "42,\"x,\"\"y\",TRUE,1.5\r\n"
+                            "-7,toolongvalue,FALSE,\n"
+                            ",,TRUE,-2";
+    parse_CSV_records({ csv.data(), csv.data() + csv.size() }, 1, table.schema(), layout, memory.data(), ',', '"',
+                      '\\', vectorized);
+
+    int32_t i;
+    double d;
+    std::memcpy(&i, value(1, 0), sizeof(i));
+    CHECK(i == 42);
+    CHECK(std::string(reinterpret_cast<const char*>(value(1, 1)), 5) == std::string("x,\"y\0", 5));
+    CHECK(bit(1, 2));
+    std::memcpy(&d, value(1, 3), sizeof(d));
+    CHECK(d == 1.5);
+
+    std::memcpy(&i, value(2, 0), sizeof(i));
+    CHECK(i == -7);
+    CHECK(std::string(reinterpret_cast<const char*>(value(2, 1)), 5) == "toolo");
+    CHECK_FALSE(bit(2, 2));
+    CHECK(is_null(2, 3));
+    CHECK_FALSE(is_null(2, 0));
+
+    CHECK(is_null(3, 0));
+    CHECK(is_null(3, 1));
+    CHECK_FALSE(is_null(3, 2));
+    std::memcpy(&d, value(3, 3), sizeof(d));
+    CHECK(d == -2);
+
+    SECTION("malformed records")
+    {
+        const std::string too_few = "1,abc,TRUE\n";
+        CHECK_THROWS_AS(parse_CSV_records({ too_few.data(), too_few.data() + too_few.size() }, 0, table.schema(),
+                                          layout, memory.data(), ',', '"', '\\', vectorized), std::invalid_argument);
+        const std::string too_many = "1,abc,TRUE,1,2\n";
+        CHECK_THROWS_AS(parse_CSV_records({ too_many.data(), too_many.data() + too_many.size() }, 0, table.schema(),
+                                          layout, memory.data(), ',', '"', '\\', vectorized), std::invalid_argument);
+        const std::string not_a_number = "x,abc,TRUE,1\n";
+        CHECK_THROWS_AS(parse_CSV_records({ not_a_number.data(), not_a_number.data() + not_a_number.size() }, 0,
+                                          table.schema(), layout, memory.data(), ',', '"', '\\', vectorized),
+                        std::invalid_argument);
+    }
+}
+
+TEST_CASE("parse_CSV_records/escaped quotes", "[milestone1]")
+{
+    const bool vectorized = GENERATE(false, true);
+    Catalog::Clear(); // drop all data
+    auto &C = m::Catalog::Get();
+
+    auto &DB = C.add_database(C.pool("test_db"));
+    auto &table = DB.add_table(C.pool("test"));
+    table.push_back(C.pool("id"),          m::Type::Get_Integer(m::Type::TY_Vector, 4));
+    table.push_back(C.pool("description"), m::Type::Get_Char(m::Type::TY_Vector, 48));
+    table.push_back(C.pool("license"),     m::Type::Get_Char(m::Type::TY_Vector, 4));
+
+    /* Fields escaped like in `resource/arch-packages.csv`, where a backslash makes the next character literal. */
+    const std::string csv = "900,\"\\\"Generate Your Projects\\\" Meta-Build system\",custom\n"
+                            "5347,\"the local computer\\'s basic\",BSD\n"
+                            "3621,\"Cargo subcommand \\\"release\\\"\",MIT\n"
+                            "1,\"a backslash \\\\\",GPL\n"
+                            "2,\"doubled \"\"quotes\"\" and \\\\\\\"\",\"a,\\\"\"\n";
+    const std::vector<std::string> descriptions = {
+        "\"Generate Your Projects\" Meta-Build system",
+        "the local computer's basic",
+        "Cargo subcommand \"release\"",
+        "a backslash \\",
+        "doubled \"quotes\" and \\\"",
+    };
+    const char *begin = csv.data(), *end = csv.data() + csv.size();
+
+    for (std::size_t num_chunks = 1; num_chunks != csv.size() + 2; ++num_chunks) {
+        auto chunks = split_CSV(begin, end, num_chunks);
+        std::size_t num_records = 0;
+        for (auto &chunk : chunks) {
+            REQUIRE(chunk.end[-1] == '\n');
+            num_records += count_CSV_records(chunk);
+        }
+        REQUIRE(num_records == descriptions.size());
+    }
+
+    std::unique_ptr<DataLayoutFactory> factory = std::make_unique<MyPAX4kLayoutFactory>();
+    auto layout = factory->make(table.schema());
+    std::vector<uint64_t> memory(4096 / sizeof(uint64_t));
+    auto bytes = reinterpret_cast<const char*>(memory.data());
+    parse_CSV_records({ begin, end }, 0, table.schema(), layout, memory.data(), ',', '"', '\\', vectorized);
+
+    /* The SIMD tokenizer stores exactly what the scalar parser stores. */
+    std::vector<uint64_t> scalar_memory(memory.size());
+    parse_CSV_records({ begin, end }, 0, table.schema(), layout, scalar_memory.data(), ',', '"', '\\', false);
+    CHECK(memory == scalar_memory);
+
+    for (std::size_t row = 0; row != descriptions.size(); ++row) {
+        const char *description = bytes + attribute_offset_in_bits(layout, row, 1) / 8;
+        CHECK(std::string(description, strnlen(description, 48)) == descriptions[row]);
+    }
+    const char *license = bytes + attribute_offset_in_bits(layout, 4, 2) / 8;
+    CHECK(std::string(license, strnlen(license, 4)) == "a,\"");
+
+    SECTION("escaping disabled")
+    {
+        /* With the quote as escape character, backslashes are ordinary characters. */
+        const std::string csv = "1,\"C:\\\",x\n";
+        parse_CSV_records({ csv.data(), csv.data() + csv.size() }, 0, table.schema(), layout, memory.data(), ',', '"',
+                          '"', vectorized);
+        const char *description = bytes + attribute_offset_in_bits(layout, 0, 1) / 8;
+        CHECK(std::string(description, strnlen(description, 48)) == "C:\\");
+    }
+
+    SECTION("escaped closing quote")
+    {
+        const std::string csv = "1,\"abc\\\",x\n";
+        CHECK_THROWS_AS(parse_CSV_records({ csv.data(), csv.data() + csv.size() }, 0, table.schema(), layout,
+                                          memory.data(), ',', '"', '\\', vectorized), std::invalid_argument);
+    }
+}
@@ -1,6 +1,10 @@
 #include <catch2/catch.hpp>
 
 #include "data_layouts.hpp"
+#include "FORColumn.hpp"
+#include "StringColumn.hpp"
+#include <limits>
+#include <sstream>
 
 
 using namespace m;
@@ -375,7 +379,7 @@ TEST_CASE("NaiveRowLayout", "[milestone1]")
         CHECK(not layout.is_finite());
 
         /* Check stride of row. */
-        CHECK(layout.stride_in_bits() == 384);
+        CHECK(layout.stride_in_bits() == 320);
 
         auto &child_node = layout.child();
 
@@ -403,8 +407,8 @@ TEST_CASE("NaiveRowLayout", "[milestone1]")
         /* salary */
         CHECK(inode->at(4).offset_in_bits == 256);
         CHECK(inode->at(4).stride_in_bits == 0);
-        /* NULL bitmap */
-        CHECK(inode->at(5).offset_in_bits == 320);
+        /* NULL bitmap, in the padding hole after in_assessment */
+        CHECK(inode->at(5).offset_in_bits == 225);
         CHECK(inode->at(5).stride_in_bits == 0);
 
         /* Validate `id`. */
@@ -470,7 +474,7 @@ TEST_CASE("NaiveRowLayout", "[milestone1]")
         table.push_back(C.pool("j_i2"), m::Type::Get_Integer(m::Type::TY_Vector, 2));   // 304:320
         table.push_back(C.pool("k_b"),  m::Type::Get_Boolean(m::Type::TY_Vector));      // 320:321
         table.push_back(C.pool("l_i2"), m::Type::Get_Integer(m::Type::TY_Vector, 2));   // 336:352
-        // NULL bitmap: 352:364
+        // NULL bitmap: 65:77, in the padding hole before e_d
 
         /* Create store and data layout. */
         table.store(C.create_store(table));
@@ -1155,3 +1159,534 @@ TEST_CASE("PAXLayout", "[milestone1]")
         CHECK(null_bitmap->type()->size() == 5);
     }
 }
+
+TEST_CASE("HybridLayout", "[milestone1]")
+{
+    Catalog::Clear(); // drop all data
+    auto &C = m::Catalog::Get();
+
+    try {
+        C.register_data_layout("hybrid", std::make_unique<MyHybridLayoutFactory>(std::vector<double>{ 1., 0., 1. }),
+                               "hybrid layout");
+    } catch (std::invalid_argument) { }
+
+    auto &DB = C.add_database(C.pool("test_db"));
+    auto &table = DB.add_table(C.pool("test"));
+
+    SECTION("two hot, one cold")
+    {
+        /* Fill table with attributes. */
+        table.push_back(C.pool("a"), m::Type::Get_Integer(m::Type::TY_Vector, 4));
+        table.push_back(C.pool("b"), m::Type::Get_Double(m::Type::TY_Vector));
+        table.push_back(C.pool("c"), m::Type::Get_Integer(m::Type::TY_Vector, 2));
+
+        /* Create store and data layout. */
+        table.store(C.create_store(table));
+        table.layout(C.data_layout("hybrid"));
+        const auto &layout = table.layout();
+
+        /* Root must be an indefinite sequence of blocks. */
+        CHECK(not layout.is_finite());
+
+        /* Check stride of block. */
+        CHECK(layout.stride_in_bits() == 4096 * 8);
+
+        auto &child_node = layout.child();
+
+        /* Check that the child INode models a block of tuples. */
+        CHECK(child_node.num_tuples() == 250);
+
+        /* Check that child node is an INode. */
+        auto inode = cast<const DataLayout::INode>(&child_node);
+        REQUIRE(inode);
+
+        /* Validate the INode: hot rows, cold minipage, and NULL bitmap. */
+        CHECK(inode->num_children() == 3);
+        CHECK(inode->at(0).offset_in_bits == 0);
+        CHECK(inode->at(0).stride_in_bits == 64);
+        CHECK(inode->at(1).offset_in_bits == 16000);
+        CHECK(inode->at(1).stride_in_bits == 64);
+        CHECK(inode->at(2).offset_in_bits == 32000);
+        CHECK(inode->at(2).stride_in_bits == 3);
+
+        /* Validate the hot rows. */
+        auto hot = cast<const DataLayout::INode>(inode->at(0).ptr.get());
+        REQUIRE(hot);
+        CHECK(hot->num_tuples() == 1);
+        CHECK(hot->num_children() == 2);
+        CHECK(hot->at(0).offset_in_bits == 0);
+        CHECK(hot->at(0).stride_in_bits == 0);
+        CHECK(hot->at(1).offset_in_bits == 32);
+        CHECK(hot->at(1).stride_in_bits == 0);
+
+        auto attr_a = cast<const DataLayout::Leaf>(hot->at(0).ptr.get());
+        REQUIRE(attr_a);
+        CHECK(attr_a->index() == 0);
+        CHECK(attr_a->type()->size() == 32);
+
+        auto attr_c = cast<const DataLayout::Leaf>(hot->at(1).ptr.get());
+        REQUIRE(attr_c);
+        CHECK(attr_c->index() == 2);
+        CHECK(attr_c->type()->size() == 16);
+
+        /* Validate the cold attribute. */
+        auto attr_b = cast<const DataLayout::Leaf>(inode->at(1).ptr.get());
+        REQUIRE(attr_b);
+        CHECK(attr_b->num_tuples() == 1);
+        CHECK(attr_b->index() == 1);
+        CHECK(attr_b->type()->is_double());
+
+        /* Validate the NULL bitmap. */
+        auto null_bitmap = cast<const DataLayout::Leaf>(inode->at(2).ptr.get());
+        REQUIRE(null_bitmap);
+        CHECK(null_bitmap->num_tuples() == 1);
+        CHECK(null_bitmap->index() == 3);
+        CHECK(null_bitmap->type()->is_bitmap());
+        CHECK(null_bitmap->type()->size() == 3);
+    }
+}
+
+TEST_CASE("compute_access_frequencies", "[milestone1]")
+{
+    std::istringstream queries(
+        "SELECT id, size / 1024 * 1024 FROM packages WHERE repo = \"size\";\n"
+        "SELECT * FROM packages;\n"
+    );
+    auto frequencies = compute_access_frequencies({ "id", "repo", "size", "description" }, queries);
+
+    REQUIRE(frequencies.size() == 4);
+    CHECK(frequencies[0] == 1.);
+    CHECK(frequencies[1] == 1.);
+    CHECK(frequencies[2] == 1.);
+    CHECK(frequencies[3] == .5);
+}
+
+TEST_CASE("PAXAutoLayout", "[milestone1]")
+{
+    SECTION("block fits in L1d")
+    {
+        MyPAXAutoLayoutFactory factory(48 * 1024, 2 * 1024 * 1024);
+        CHECK(factory.block_size_in_bytes(33) == 32 * 1024);
+        /* A schema without attributes has zero-sized tuples, which fit into any block. */
+        CHECK(factory.block_size_in_bytes(0) == 32 * 1024);
+    }
+
+    SECTION("wide tuples grow the block towards L2")
+    {
+        MyPAXAutoLayoutFactory factory(32 * 1024, 1024 * 1024);
+        /* 32 KiB hold only 32 tuples of 1 KiB each, hence the block is doubled once. */
+        CHECK(factory.block_size_in_bytes(1024 * 8) == 64 * 1024);
+        /* A block must not exceed half of L2. */
+        CHECK(factory.block_size_in_bytes(64 * 1024 * 8) == 512 * 1024);
+    }
+
+    SECTION("unknown cache sizes")
+    {
+        MyPAXAutoLayoutFactory factory(0, 0);
+        CHECK(factory.block_size_in_bytes(33) == 4096);
+    }
+}
+
+TEST_CASE("DSMLayout", "[milestone1]")
+{
+    Catalog::Clear(); // drop all data
+    auto &C = m::Catalog::Get();
+
+    try {
+        C.register_data_layout("DSM", std::make_unique<MyDSMLayoutFactory>(), "columnar layout (DSM)");
+    } catch (std::invalid_argument) { }
+
+    auto &DB = C.add_database(C.pool("test_db"));
+    auto &table = DB.add_table(C.pool("test"));
+
+    /* Fill table with attributes. */
+    table.push_back(C.pool("a"), m::Type::Get_Integer(m::Type::TY_Vector, 4));
+    table.push_back(C.pool("b"), m::Type::Get_Double(m::Type::TY_Vector));
+    table.store(C.create_store(table));
+
+    SECTION("sized from hint")
+    {
+        auto layout = C.data_layout("DSM").make(table.schema(), 1000);
+
+        /* Root must be an indefinite sequence of blocks. */
+        CHECK(not layout.is_finite());
+
+        /* 1000 tuples are rounded up to 1024; 1024 * (32 + 64) + 1024 * 2 bits. */
+        CHECK(layout.stride_in_bits() == 100352);
+
+        auto &child_node = layout.child();
+        CHECK(child_node.num_tuples() == 1024);
+
+        auto inode = cast<const DataLayout::INode>(&child_node);
+        REQUIRE(inode);
+
+        /* Validate the INode. */
+        CHECK(inode->num_children() == 3);
+        CHECK(inode->at(0).offset_in_bits == 0);
+        CHECK(inode->at(0).stride_in_bits == 32);
+        CHECK(inode->at(1).offset_in_bits == 32768);
+        CHECK(inode->at(1).stride_in_bits == 64);
+        CHECK(inode->at(2).offset_in_bits == 98304);
+        CHECK(inode->at(2).stride_in_bits == 2);
+
+        /* Validate the NULL bitmap. */
+        auto null_bitmap = cast<const DataLayout::Leaf>(inode->at(2).ptr.get());
+        REQUIRE(null_bitmap);
+        CHECK(null_bitmap->index() == 2);
+        CHECK(null_bitmap->type()->is_bitmap());
+        CHECK(null_bitmap->type()->size() == 2);
+    }
+
+    SECTION("without hint")
+    {
+        auto layout = C.data_layout("DSM").make(table.schema());
+        CHECK(layout.child().num_tuples() == MyDSMLayoutFactory::DEFAULT_TUPLES_PER_BLOCK);
+
+        /* Every column starts at a cache line. */
+        auto inode = cast<const DataLayout::INode>(&layout.child());
+        REQUIRE(inode);
+        for (auto &child : *inode)
+            CHECK(child.offset_in_bits % 512 == 0);
+    }
+}
+
+TEST_CASE("RowLayout/NOT NULL", "[milestone1]")
+{
+    Catalog::Clear(); // drop all data
+    auto &C = m::Catalog::Get();
+
+    try {
+        C.register_data_layout("row_naive_notnull", std::make_unique<MyNaiveRowLayoutFactory>(false),
+                               "row layout (naïve) without NULL bitmap");
+        C.register_data_layout("row_optimized_notnull", std::make_unique<MyOptimizedRowLayoutFactory>(false),
+                               "row layout (optimized) without NULL bitmap");
+    } catch (std::invalid_argument) { }
+
+    auto &DB = C.add_database(C.pool("test_db"));
+    auto &table = DB.add_table(C.pool("test"));
+
+    /* Fill table with attributes. */
+    table.push_back(C.pool("a"), m::Type::Get_Boolean(m::Type::TY_Vector));
+    table.push_back(C.pool("b"), m::Type::Get_Integer(m::Type::TY_Vector, 4));
+    table.store(C.create_store(table));
+
+    for (const char *name : { "row_naive_notnull", "row_optimized_notnull" }) {
+        DYNAMIC_SECTION(name)
+        {
+            table.layout(C.data_layout(name));
+            const auto &layout = table.layout();
+
+            /* Check stride of row. */
+            CHECK(layout.stride_in_bits() == 64);
+
+            auto inode = cast<const DataLayout::INode>(&layout.child());
+            REQUIRE(inode);
+
+            /* There must be no NULL bitmap. */
+            CHECK(inode->num_children() == 2);
+            for (auto &child : *inode)
+                CHECK(not cast<const DataLayout::Leaf>(child.ptr.get())->type()->is_bitmap());
+        }
+    }
+}
+
+TEST_CASE("PackedRowLayout", "[milestone1]")
+{
+    Catalog::Clear(); // drop all data
+    auto &C = m::Catalog::Get();
+
+    auto &DB = C.add_database(C.pool("test_db"));
+    auto &table = DB.add_table(C.pool("test"));
+
+    SECTION("no groups")
+    {
+        /* Fill table with attributes. */
+        table.push_back(C.pool("a_i4"), m::Type::Get_Integer(m::Type::TY_Vector, 4));
+        table.push_back(C.pool("b_b"),  m::Type::Get_Boolean(m::Type::TY_Vector));
+        table.push_back(C.pool("c_c3"), m::Type::Get_Char(m::Type::TY_Vector, 3));
+        table.push_back(C.pool("d_d"),  m::Type::Get_Double(m::Type::TY_Vector));
+        table.push_back(C.pool("e_c5"), m::Type::Get_Char(m::Type::TY_Vector, 5));
+        table.push_back(C.pool("f_i2"), m::Type::Get_Integer(m::Type::TY_Vector, 2));
+
+        std::unique_ptr<DataLayoutFactory> factory = std::make_unique<MyPackedRowLayoutFactory>();
+        auto layout = factory->make(table.schema());
+
+        /* 32 + 1 + 24 + 64 + 40 + 16 + 6 bits, without any padding but at the end. */
+        CHECK(layout.stride_in_bits() == 192);
+    }
+
+    SECTION("group placed first")
+    {
+        /* Fill table with attributes. */
+        table.push_back(C.pool("a"), m::Type::Get_Boolean(m::Type::TY_Vector));
+        table.push_back(C.pool("b"), m::Type::Get_Integer(m::Type::TY_Vector, 4));
+        table.push_back(C.pool("c"), m::Type::Get_Char(m::Type::TY_Vector, 3));
+
+        std::unique_ptr<DataLayoutFactory> factory =
+            std::make_unique<MyPackedRowLayoutFactory>(std::vector<std::vector<std::size_t>>{ { 0 } });
+        auto layout = factory->make(table.schema());
+
+        /* Sorting `b` and `c` by alignment would leave a hole before `b` and require 96 bits. */
+        CHECK(layout.stride_in_bits() == 64);
+
+        auto inode = cast<const DataLayout::INode>(&layout.child());
+        REQUIRE(inode);
+        CHECK(inode->num_children() == 4);
+        CHECK(inode->at(0).offset_in_bits == 0);
+        CHECK(inode->at(1).offset_in_bits == 32);
+        CHECK(inode->at(2).offset_in_bits == 8);
+        /* NULL bitmap, in the padding hole after `a` */
+        CHECK(inode->at(3).offset_in_bits == 1);
+    }
+
+    SECTION("group does not cross a cache line")
+    {
+        /* Fill table with attributes. */
+        table.push_back(C.pool("a"), m::Type::Get_Char(m::Type::TY_Vector, 10));
+        table.push_back(C.pool("b"), m::Type::Get_Char(m::Type::TY_Vector, 60));
+        table.push_back(C.pool("c"), m::Type::Get_Integer(m::Type::TY_Vector, 4));
+
+        std::unique_ptr<DataLayoutFactory> factory =
+            std::make_unique<MyPackedRowLayoutFactory>(std::vector<std::vector<std::size_t>>{ { 0 }, { 1 } });
+        auto layout = factory->make(table.schema());
+
+        CHECK(layout.stride_in_bits() == 1024);
+
+        auto inode = cast<const DataLayout::INode>(&layout.child());
+        REQUIRE(inode);
+        CHECK(inode->at(0).offset_in_bits == 0);
+        CHECK(inode->at(1).offset_in_bits == 512);
+        CHECK(inode->at(2).offset_in_bits == 992);
+        CHECK(inode->at(3).offset_in_bits == 80);
+    }
+
+    SECTION("groups do not cross a cache line in any row")
+    {
+        /* Fill table with attributes. */
+        table.push_back(C.pool("a"), m::Type::Get_Integer(m::Type::TY_Vector, 4));
+        table.push_back(C.pool("b"), m::Type::Get_Char(m::Type::TY_Vector, 3));
+        table.push_back(C.pool("c"), m::Type::Get_Char(m::Type::TY_Vector, 10));
+
+        std::unique_ptr<DataLayoutFactory> factory =
+            std::make_unique<MyPackedRowLayoutFactory>(std::vector<std::vector<std::size_t>>{ { 0, 1 } });
+        auto layout = factory->make(table.schema());
+
+        /* 139 bits would be padded to 160 bits by alignment alone, such that the group of row 3 straddled a line. */
+        CHECK(layout.stride_in_bits() == 256);
+
+        for (std::size_t row : { 0, 1, 3, 7 }) {
+            const uint64_t begin = attribute_offset_in_bits(layout, row, 0);
+            const uint64_t end = attribute_offset_in_bits(layout, row, 1) + 24;
+            CHECK(begin / 512 == (end - 1) / 512);
+        }
+    }
+}
+
+TEMPLATE_TEST_CASE("FORColumn", "[milestone1]", int8_t, int32_t, uint32_t, int64_t)
+{
+    using column_type = FORColumn<TestType, 64>;
+    using limits = std::numeric_limits<TestType>;
+
+    std::vector<TestType> values;
+
+    SECTION("empty")
+    {
+        column_type column;
+        CHECK(column.size() == 0);
+        CHECK(column.num_blocks() == 0);
+    }
+
+    SECTION("monotonically increasing")
+    {
+        for (std::size_t i = 0; i != 200; ++i)
+            values.push_back(TestType(i % 100));
+        auto column = column_type::Encode(values.begin(), values.end());
+
+        REQUIRE(column.size() == 200);
+        REQUIRE(column.num_blocks() == 4);
+        CHECK(column.min(0) == 0);
+        CHECK(column.max(0) == 63);
+        CHECK(column.min(1) == 0);
+        CHECK(column.max(1) == 99);
+        CHECK(column.block_size(3) == 8);
+        /* 64 deltas of at most 6 resp. 7 bits; 8 bit values do not amortize the block headers */
+        if constexpr (sizeof(TestType) >= 4)
+            CHECK(column.size_in_bytes() < values.size() * sizeof(TestType));
+    }
+
+    SECTION("constant")
+    {
+        values.assign(100, TestType(42));
+        auto column = column_type::Encode(values.begin(), values.end());
+        CHECK(column.min(0) == 42);
+        CHECK(column.max(0) == 42);
+    }
+
+    SECTION("full value range")
+    {
+        for (std::size_t i = 0; i != 130; ++i)
+            values.push_back(i % 2 ? limits::max() : limits::min());
+        values.push_back(limits::min() + 1);
+        auto column = column_type::Encode(values.begin(), values.end());
+        CHECK(column.min(0) == limits::min());
+        CHECK(column.max(0) == limits::max());
+    }
+
+    SECTION("pseudo-random")
+    {
+        uint64_t state = 42;
+        for (std::size_t i = 0; i != 1000; ++i) {
+            state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+            values.push_back(TestType(state >> (i % 64)));
+        }
+    }
+
+    auto column = column_type::Encode(values.begin(), values.end());
+    REQUIRE(column.size() == values.size());
+
+    /* Decode all values at once. */
+    std::vector<TestType> decoded(values.size());
+    column.decode(decoded.data());
+    CHECK(decoded == values);
+
+    /* Decode values individually. */
+    for (std::size_t i = 0; i != values.size(); ++i)
+        REQUIRE(column[i] == values[i]);
+
+    /* Check the block synopses. */
+    for (std::size_t b = 0; b != column.num_blocks(); ++b) {
+        auto first = values.begin() + b * column_type::TUPLES_PER_BLOCK;
+        auto [min, max] = std::minmax_element(first, first + column.block_size(b));
+        CHECK(column.min(b) == *min);
+        CHECK(column.max(b) == *max);
+    }
+}
+
+TEST_CASE("StringColumn", "[milestone1]")
+{
+    using column_type = StringColumn<4>;
+    const std::vector<std::string> strings = {
+        "", "abc", "abcd", "abcde", "abcdefghijkl", "abcdefghijklm", "linux-firmware", "linux-api-headers", "lib32-zlib",
+    };
+
+    column_type column;
+    for (auto &str : strings)
+        column.append(str);
+
+    REQUIRE(column.size() == strings.size());
+    CHECK(column.num_blocks() == 3);
+    /* Only the strings longer than 12 bytes occupy heap space, namely their bytes beyond the prefix. */
+    CHECK(column.size_in_bytes() == 9 * 16 + (13 - 4) + (14 - 4) + (17 - 4));
+
+    for (std::size_t i = 0; i != strings.size(); ++i) {
+        CHECK(column.get(i) == strings[i]);
+        for (std::size_t j = 0; j != strings.size(); ++j)
+            CHECK(column.equals(i, strings[j]) == (i == j));
+    }
+
+    CHECK(column.equals(6, "linux-firmware"));
+    CHECK_FALSE(column.equals(6, "linux-firmwarf"));
+    CHECK_FALSE(column.equals(6, "linux"));
+
+    CHECK(column.starts_with(0, ""));
+    CHECK(column.starts_with(6, "linux"));
+    CHECK(column.starts_with(7, "linux-api"));
+    CHECK_FALSE(column.starts_with(6, "linux-api"));
+    CHECK_FALSE(column.starts_with(8, "linux"));
+    CHECK_FALSE(column.starts_with(1, "abcd"));
+    CHECK(column.starts_with(5, "abcdefghijklm"));
+    CHECK_FALSE(column.starts_with(4, "abcdefghijklm"));
+}
+
+TEST_CASE("CacheAlignedRowLayout", "[milestone1]")
+{
+    Catalog::Clear(); // drop all data
+    auto &C = m::Catalog::Get();
+
+    auto &DB = C.add_database(C.pool("test_db"));
+    auto &table = DB.add_table(C.pool("test"));
+
+    SECTION("narrow rows")
+    {
+        table.push_back(C.pool("a_i4"), m::Type::Get_Integer(m::Type::TY_Vector, 4));
+        table.push_back(C.pool("b_c3"), m::Type::Get_Char(m::Type::TY_Vector, 3));
+        table.push_back(C.pool("c_b"),  m::Type::Get_Boolean(m::Type::TY_Vector));
+
+        std::unique_ptr<DataLayoutFactory> factory = std::make_unique<MyCacheAlignedRowLayoutFactory>();
+        auto layout = factory->make(table.schema());
+
+        /* 60 bits, rounded up to the next power of two */
+        CHECK(layout.stride_in_bits() == 64);
+        CHECK(layout.child().num_tuples() == 1);
+    }
+
+    SECTION("wide rows start at a cache line")
+    {
+        table.push_back(C.pool("a_c70"), m::Type::Get_Char(m::Type::TY_Vector, 70));
+        table.push_back(C.pool("b_i2"),  m::Type::Get_Integer(m::Type::TY_Vector, 2));
+
+        std::unique_ptr<DataLayoutFactory> factory = std::make_unique<MyCacheAlignedRowLayoutFactory>();
+        auto layout = factory->make(table.schema());
+
+        CHECK(layout.stride_in_bits() == 1024);
+    }
+
+    SECTION("hot and cold rows")
+    {
+        table.push_back(C.pool("a_i4"),  m::Type::Get_Integer(m::Type::TY_Vector, 4));
+        table.push_back(C.pool("b_c80"), m::Type::Get_Char(m::Type::TY_Vector, 80));
+        table.push_back(C.pool("c_i8"),  m::Type::Get_Integer(m::Type::TY_Vector, 8));
+
+        std::unique_ptr<DataLayoutFactory> factory =
+            std::make_unique<MyCacheAlignedRowLayoutFactory>(std::vector<std::size_t>{ 0, 2 });
+        auto layout = factory->make(table.schema());
+
+        /* hot rows of 64 + 32 + 3 bits padded to 128 bits, cold rows of 640 bits */
+        constexpr std::size_t N = MyCacheAlignedRowLayoutFactory::TUPLES_PER_BLOCK;
+        CHECK(layout.child().num_tuples() == N);
+        CHECK(layout.stride_in_bits() == N * (128 + 640));
+
+        auto block = cast<const DataLayout::INode>(&layout.child());
+        REQUIRE(block);
+        REQUIRE(block->num_children() == 2);
+        CHECK(block->at(0).offset_in_bits == 0);
+        CHECK(block->at(0).stride_in_bits == 128);
+        CHECK(block->at(1).offset_in_bits == N * 128);
+        CHECK(block->at(1).stride_in_bits == 640);
+
+        CHECK(attribute_offset_in_bits(layout, 5, 2) == 5 * 128);
+        CHECK(attribute_offset_in_bits(layout, 5, 0) == 5 * 128 + 64);
+        CHECK(attribute_offset_in_bits(layout, 5, 3) == 5 * 128 + 96);
+        CHECK(attribute_offset_in_bits(layout, 5, 1) == N * 128 + 5 * 640);
+        CHECK(attribute_offset_in_bits(layout, N + 6, 0) == N * (128 + 640) + 6 * 128 + 64);
+
+        /* No hot attributes of any tuple straddle a cache line. */
+        for (std::size_t row = 0; row != 2 * N; ++row) {
+            const uint64_t begin = attribute_offset_in_bits(layout, row, 2);
+            const uint64_t end = attribute_offset_in_bits(layout, row, 0) + 32;
+            REQUIRE(begin / 512 == (end - 1) / 512);
+        }
+    }
+}
+
+TEST_CASE("attribute_offset_in_bits", "[milestone1]")
+{
+    Catalog::Clear(); // drop all data
+    auto &C = m::Catalog::Get();
+
+    auto &DB = C.add_database(C.pool("test_db"));
+    auto &table = DB.add_table(C.pool("test"));
+    table.push_back(C.pool("a_i4"), m::Type::Get_Integer(m::Type::TY_Vector, 4));
+    table.push_back(C.pool("b_d"),  m::Type::Get_Double(m::Type::TY_Vector));
+
+    std::unique_ptr<DataLayoutFactory> factory = std::make_unique<MyPAX4kLayoutFactory>();
+    auto layout = factory->make(table.schema());
+    auto block = cast<const DataLayout::INode>(&layout.child());
+    REQUIRE(block);
+    const std::size_t N = block->num_tuples();
+
+    CHECK(attribute_offset_in_bits(layout, 0, 0) == block->at(0).offset_in_bits);
+    CHECK(attribute_offset_in_bits(layout, 3, 1) == block->at(1).offset_in_bits + 3 * 64);
+    CHECK(attribute_offset_in_bits(layout, N + 3, 1) == 4096 * 8 + block->at(1).offset_in_bits + 3 * 64);
+    CHECK(attribute_offset_in_bits(layout, N + 3, 2) == 4096 * 8 + block->at(2).offset_in_bits + 3 * 2);
+}
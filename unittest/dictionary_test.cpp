@@ -0,0 +1,106 @@
+#include <catch2/catch.hpp>
+
+#include "csv.hpp"
+#include "dictionary.hpp"
+#include <sstream>
+
+
+TEST_CASE("Dictionary", "[milestone1]")
+{
+    Dictionary dict;
+
+    SECTION("codes are dense and stable")
+    {
+        CHECK(dict.encode("core") == 0);
+        CHECK(dict.encode("extra") == 1);
+        CHECK(dict.encode("core") == 0);
+        CHECK(dict.size() == 2);
+        CHECK(dict.decode(1) == "extra");
+        CHECK(dict.find("extra") == 1);
+        CHECK(dict.find("community") == Dictionary::NOT_FOUND);
+    }
+
+    SECTION("rewrite predicates")
+    {
+        dict.encode("core");
+        dict.encode("extra");
+        const std::unordered_map<std::string, const Dictionary*> attributes = { { "repo", &dict } };
+
+        CHECK(rewrite_dictionary_predicates("SELECT id FROM packages WHERE repo = \"extra\";", attributes) ==
+              "SELECT id FROM packages WHERE repo = 1;");
+        CHECK(rewrite_dictionary_predicates("SELECT id FROM packages WHERE \"core\"<>packages.repo;", attributes) ==
+              "SELECT id FROM packages WHERE 0<>packages.repo;");
+        CHECK(rewrite_dictionary_predicates("SELECT id FROM packages WHERE repo = \"testing\";", attributes) ==
+              "SELECT id FROM packages WHERE repo = -1;");
+        /* Other attributes and non-equality predicates remain untouched. */
+        CHECK(rewrite_dictionary_predicates("SELECT repo FROM packages WHERE pkg_name = \"core\";", attributes) ==
+              "SELECT repo FROM packages WHERE pkg_name = \"core\";");
+        CHECK(rewrite_dictionary_predicates("SELECT id FROM packages WHERE repo < \"core\";", attributes) ==
+              "SELECT id FROM packages WHERE repo < \"core\";");
+    }
+}
+
+TEST_CASE("dictionary_encode_CSV", "[milestone1]")
+{
+    std::istringstream in(
+        "id,repo,description\n"
+        "0,core,\"Access control list utilities, libraries and headers\"\n"
+        "1,extra,plain\n"
+        "2,core,\n"
+    );
+    std::ostringstream out;
+
+    auto dicts = dictionary_encode_CSV(in, out, { 1 }, { 10 });
+
+    REQUIRE(dicts.size() == 1);
+    CHECK(dicts[0].size() == 2);
+    CHECK(out.str() ==
+        "id,repo,description\n"
+        "0,0,\"Access control list utilities, libraries and headers\"\n"
+        "1,1,plain\n"
+        "2,0,\n"
+    );
+
+    std::istringstream encoded(out.str());
+    std::vector<std::string> fields;
+    REQUIRE(read_CSV_record(encoded, fields));
+    REQUIRE(read_CSV_record(encoded, fields));
+    REQUIRE(fields.size() == 3);
+    CHECK(fields[2] == "Access control list utilities, libraries and headers");
+}
+
+TEST_CASE("dictionary_encode_CSV/escaped quotes", "[milestone1]")
+{
+    /* Quotes escaped with a backslash, like in `resource/arch-packages.csv` and as read by `m::load_from_CSV()`. */
+    const std::string description = "\"A free game like \\\"Singstar\\\", \\\"Rockband\\\" or \\\"Stepmania\\\"\"";
+    std::istringstream in(
+        "id,repo,description\n"
+        "7264,community," + description + "\n"
+        "1,\"back\\\\slash\",\"doubled \"\"quotes\"\"\"\n"
+    );
+    std::ostringstream out;
+
+    auto dicts = dictionary_encode_CSV(in, out, { 1 }, { 10 });
+
+    REQUIRE(dicts.size() == 1);
+    CHECK(dicts[0].decode(1) == "back\\slash");
+    /* Fields are written back with the same escape convention. */
+    CHECK(out.str() ==
+        "id,repo,description\n"
+        "7264,0," + description + "\n"
+        "1,1,\"doubled \\\"quotes\\\"\"\n"
+    );
+
+    std::istringstream encoded(out.str());
+    std::vector<std::string> fields;
+    REQUIRE(read_CSV_record(encoded, fields));
+    REQUIRE(read_CSV_record(encoded, fields));
+    REQUIRE(fields.size() == 3);
+    CHECK(fields[2] == "A free game like \"Singstar\", \"Rockband\" or \"Stepmania\"");
+    REQUIRE(read_CSV_record(encoded, fields));
+    CHECK(fields[2] == "doubled \"quotes\"");
+
+    std::ostringstream dict_out;
+    write_dictionary_CSV(dict_out, dicts[0]);
+    CHECK(dict_out.str() == "code,value\n0,community\n1,\"back\\\\slash\"\n");
+}
@@ -0,0 +1,111 @@
+#include <catch2/catch.hpp>
+
+#include "data_layouts.hpp"
+#include "memory_report.hpp"
+#include <algorithm>
+#include <sstream>
+#include <tuple>
+#include <vector>
+
+
+using namespace m;
+using namespace m::storage;
+
+
+TEST_CASE("compute_footprint", "[milestone1]")
+{
+    Catalog::Clear(); // drop all data
+    auto &C = m::Catalog::Get();
+
+    auto &DB = C.add_database(C.pool("test_db"));
+    auto &table = DB.add_table(C.pool("test"));
+    table.push_back(C.pool("a"), m::Type::Get_Integer(m::Type::TY_Vector, 4));
+    table.push_back(C.pool("b"), m::Type::Get_Char(m::Type::TY_Vector, 3));
+    table.push_back(C.pool("c"), m::Type::Get_Double(m::Type::TY_Vector));
+    table.push_back(C.pool("d"), m::Type::Get_Boolean(m::Type::TY_Vector));
+
+    std::vector<std::pair<const char*, std::unique_ptr<DataLayoutFactory>>> factories;
+    factories.emplace_back("row_naive", std::make_unique<MyNaiveRowLayoutFactory>());
+    factories.emplace_back("row_optimized", std::make_unique<MyOptimizedRowLayoutFactory>());
+    factories.emplace_back("row_optimized_notnull", std::make_unique<MyOptimizedRowLayoutFactory>(false));
+    factories.emplace_back("row_packed", std::make_unique<MyPackedRowLayoutFactory>());
+    factories.emplace_back("row_cache_aligned", std::make_unique<MyCacheAlignedRowLayoutFactory>());
+    factories.emplace_back("PAX4k", std::make_unique<MyPAX4kLayoutFactory>());
+    factories.emplace_back("PAX_zone_maps", std::make_unique<MyPAXZoneMapLayoutFactory>());
+    factories.emplace_back("DSM", std::make_unique<MyDSMLayoutFactory>());
+    factories.emplace_back("hybrid", std::make_unique<MyHybridLayoutFactory>(std::vector<double>{ 1., 0., 1., 0. }));
+
+    auto footprint_of = [&](const DataLayoutFactory &factory) {
+        return compute_footprint(table.schema(), factory.make(table.schema()));
+    };
+
+    for (auto &[name, factory] : factories) {
+        DYNAMIC_SECTION(name)
+        {
+            auto layout = factory->make(table.schema());
+            const auto footprint = compute_footprint(table.schema(), layout);
+            const std::size_t n = footprint.tuples_per_block;
+            CHECK(n == layout.child().num_tuples());
+
+            /* Every attribute is stored once per tuple, and the components account for every bit of a block. */
+            CHECK(footprint.attributes[0].payload_in_bits == 32 * n);
+            CHECK(footprint.attributes[1].payload_in_bits == 24 * n);
+            CHECK(footprint.attributes[2].payload_in_bits == 64 * n);
+            CHECK(footprint.attributes[3].payload_in_bits == 1 * n);
+            CHECK(footprint.payload_in_bits() == 121 * n);
+            CHECK(footprint.payload_in_bits() + footprint.padding_in_bits() + footprint.null_bitmap().payload_in_bits +
+                  footprint.null_bitmap().padding_in_bits + footprint.header_in_bits +
+                  footprint.unused_tail_in_bits == footprint.block_size_in_bits);
+
+            /* Only blocks of multiple tuples have a header or an unused tail. */
+            if (n == 1)
+                CHECK(footprint.header_in_bits + footprint.unused_tail_in_bits == 0);
+
+            /* Only layouts for NOT NULL attributes omit the NULL bitmap. */
+            CHECK((footprint.null_bitmap().payload_in_bits == 0) == (std::string(name) == "row_optimized_notnull"));
+
+            std::ostringstream out;
+            print_footprint_csv(out, name, table.schema(), footprint);
+            const std::string csv = out.str();
+            CHECK(std::count(csv.begin(), csv.end(), '\n') == 4 + 4);
+        }
+    }
+
+    SECTION("naive row")
+    {
+        /* a at 0, b at 32, the bitmap in the hole at 56, and c at 64, behind 4 bits of padding. */
+        auto footprint = footprint_of(MyNaiveRowLayoutFactory());
+        REQUIRE(footprint.block_size_in_bits == 192);
+        CHECK(footprint.null_bitmap().payload_in_bits == 4);
+        CHECK(footprint.attributes[2].padding_in_bits == 4);
+        CHECK(footprint.padding_in_bits() == 192 - 121 - 4);
+    }
+
+    SECTION("PAX4k")
+    {
+        /* The remainder of a block that cannot hold another tuple is the unused tail. */
+        auto footprint = footprint_of(MyPAX4kLayoutFactory());
+        const std::size_t n = footprint.tuples_per_block;
+        CHECK(footprint.block_size_in_bits == 4096 * 8);
+        CHECK(footprint.unused_tail_in_bits < 121 + 4 + footprint.padding_in_bits() / n + 64);
+        CHECK(footprint.unused_tail_in_bits > 0);
+        CHECK(footprint.header_in_bits == 0);
+    }
+
+    SECTION("PAX with zone maps")
+    {
+        /* The synopses of the numeric attributes `a` and `c` form the block header. */
+        auto footprint = footprint_of(MyPAXZoneMapLayoutFactory());
+        CHECK(footprint.header_in_bits == 2 * MyPAXZoneMapLayoutFactory::SYNOPSIS_SIZE_IN_BITS);
+    }
+
+    SECTION("print_footprint")
+    {
+        auto footprint = footprint_of(MyNaiveRowLayoutFactory());
+        std::ostringstream out;
+        print_footprint(out, table.schema(), footprint, 1000, 32 * 1000);
+        CHECK(out.str().find("1000 blocks for 1000 tuples") != std::string::npos);
+        CHECK(out.str().find("24000 bytes in blocks, of which 15125 bytes payload; 32000 bytes allocated, of which "
+                             "8000 bytes unused") != std::string::npos);
+    }
+}
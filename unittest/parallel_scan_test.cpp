@@ -0,0 +1,114 @@
+#include <catch2/catch.hpp>
+
+#include "column_writer.hpp"
+#include "data_layouts.hpp"
+#include "parallel_scan.hpp"
+#include <numeric>
+#include <vector>
+
+
+using namespace m;
+using namespace m::storage;
+
+
+TEST_CASE("MorselQueue", "[milestone1]")
+{
+    std::vector<morsel> morsels(1000);
+    for (std::size_t i = 0; i != morsels.size(); ++i)
+        morsels[i] = { i, 1 };
+
+    for (std::size_t num_workers : { 1, 3, 8 }) {
+        MorselQueue queue(morsels, num_workers);
+        std::vector<std::atomic<unsigned>> taken(morsels.size());
+        {
+            /* Worker 0 takes no morsels, such that the others must steal its range. */
+            std::vector<std::jthread> threads;
+            for (std::size_t worker = num_workers > 1; worker < num_workers; ++worker) {
+                threads.emplace_back([&, worker]() {
+                    for (std::size_t m; (m = queue.next(worker)) != std::size_t(-1);)
+                        ++taken[m];
+                });
+            }
+            if (num_workers == 1) {
+                for (std::size_t m; (m = queue.next(0)) != std::size_t(-1);)
+                    ++taken[m];
+            }
+        }
+        for (auto &t : taken)
+            REQUIRE(t == 1);
+        CHECK(queue.next(0) == std::size_t(-1));
+    }
+}
+
+TEST_CASE("parallel_scan", "[milestone1]")
+{
+    Catalog::Clear(); // drop all data
+    auto &C = m::Catalog::Get();
+
+    auto &DB = C.add_database(C.pool("test_db"));
+    auto &table = DB.add_table(C.pool("full_scan"));
+    table.push_back(C.pool("key"),    m::Type::Get_Integer(m::Type::TY_Vector, 4));
+    table.push_back(C.pool("value0"), m::Type::Get_Integer(m::Type::TY_Vector, 4));
+
+    const std::size_t num_rows = 100000;
+    std::vector<int32_t> keys(num_rows), values(num_rows);
+    std::iota(keys.begin(), keys.end(), 0);
+    for (std::size_t i = 0; i != num_rows; ++i)
+        values[i] = 2 * i;
+    uint64_t expected = 0;
+    for (std::size_t i = 0; i != num_rows; ++i)
+        expected += 3 * keys[i] + 5 * values[i];
+
+    /* Sums up the weighted values and counts the tuples. */
+    struct checksum
+    {
+        uint64_t sum = 0;
+        std::size_t num_tuples = 0;
+
+        void operator()(const void *const *columns, std::size_t n) {
+            auto k = static_cast<const int32_t*>(columns[0]), v = static_cast<const int32_t*>(columns[1]);
+            for (std::size_t i = 0; i != n; ++i)
+                sum += 3 * k[i] + 5 * v[i];
+            num_tuples += n;
+        }
+    };
+
+    std::vector<std::pair<const char*, std::unique_ptr<DataLayoutFactory>>> factories;
+    factories.emplace_back("row_optimized", std::make_unique<MyOptimizedRowLayoutFactory>());
+    factories.emplace_back("PAX4k", std::make_unique<MyPAX4kLayoutFactory>());
+    factories.emplace_back("DSM", std::make_unique<MyDSMLayoutFactory>());
+
+    for (auto &[name, factory] : factories) {
+        DYNAMIC_SECTION(name)
+        {
+            auto layout = factory->make(table.schema());
+            const std::size_t tuples_per_block = layout.child().num_tuples();
+            const std::size_t num_blocks = (num_rows + tuples_per_block - 1) / tuples_per_block;
+            std::vector<uint64_t> memory(num_blocks * layout.stride_in_bits() / 64 + 1);
+            write_columns(table.schema(), layout, memory.data(), 0, num_rows, { { keys.data() }, { values.data() } });
+
+            /* Morsels cover all tuples and begin at block boundaries. */
+            auto morsels = make_morsels(layout, num_rows, 5000);
+            std::size_t next_row = 0;
+            for (auto &M : morsels) {
+                REQUIRE(M.first_row == next_row);
+                REQUIRE(M.first_row % tuples_per_block == 0);
+                next_row += M.num_rows;
+            }
+            REQUIRE(next_row == num_rows);
+
+            for (unsigned num_threads : { 1, 2, 5 }) {
+                auto consumers = parallel_scan(table.schema(), layout, memory.data(), num_rows, { 0, 1 },
+                                               num_threads, checksum{}, 1000);
+                REQUIRE(consumers.size() == num_threads);
+                checksum total;
+                for (auto &c : consumers) {
+                    total.sum += c.sum;
+                    total.num_tuples += c.num_tuples;
+                }
+                CHECK(total.num_tuples == num_rows);
+                CHECK(total.sum == expected);
+            }
+        }
+    }
+}
@@ -0,0 +1,105 @@
+#include <catch2/catch.hpp>
+
+#include "column_writer.hpp"
+#include "data_layouts.hpp"
+#include "scan_kernels.hpp"
+#include <algorithm>
+#include <tuple>
+#include <vector>
+
+
+using namespace m;
+using namespace m::storage;
+
+
+TEST_CASE("scan_columns", "[milestone1]")
+{
+    Catalog::Clear(); // drop all data
+    auto &C = m::Catalog::Get();
+
+    /* The table of the full and partial scan of the milestone 1 benchmark, which has generated kernels. */
+    auto &DB = C.add_database(C.pool("test_db"));
+    auto &table = DB.add_table(C.pool("full_scan"));
+    table.push_back(C.pool("key"),    m::Type::Get_Integer(m::Type::TY_Vector, 4));
+    table.push_back(C.pool("value0"), m::Type::Get_Integer(m::Type::TY_Vector, 4));
+    table.push_back(C.pool("value1"), m::Type::Get_Integer(m::Type::TY_Vector, 4));
+    table.push_back(C.pool("value2"), m::Type::Get_Integer(m::Type::TY_Vector, 4));
+
+    const std::size_t num_rows = 2000;
+    std::vector<int32_t> values[4];
+    for (std::size_t attr = 0; attr != 4; ++attr) {
+        for (std::size_t i = 0; i != num_rows; ++i)
+            values[attr].push_back(i * (attr + 1));
+    }
+    const std::vector<column_batch> columns = {
+        { values[0].data() }, { values[1].data() }, { values[2].data() }, { values[3].data() }
+    };
+
+    std::vector<std::tuple<const char*, std::unique_ptr<DataLayoutFactory>, bool>> factories;
+    factories.emplace_back("row_naive", std::make_unique<MyNaiveRowLayoutFactory>(), true);
+    factories.emplace_back("row_optimized", std::make_unique<MyOptimizedRowLayoutFactory>(), true);
+    factories.emplace_back("PAX4k", std::make_unique<MyPAX4kLayoutFactory>(), true);
+    factories.emplace_back("PAX16k", std::make_unique<MyPAXLayoutFactory>(16 * 1024), false);
+    factories.emplace_back("hybrid", std::make_unique<MyHybridLayoutFactory>(std::vector<double>{ 1., 0., 0., 1. }),
+                           false);
+
+    for (auto &[name, factory, is_generated] : factories) {
+        DYNAMIC_SECTION(name)
+        {
+            auto layout = factory->make(table.schema());
+            const std::size_t tuples_per_block = layout.child().num_tuples();
+            const std::size_t num_blocks = (num_rows + tuples_per_block - 1) / tuples_per_block;
+            std::vector<uint64_t> memory(num_blocks * layout.stride_in_bits() / 64 + 1);
+            write_columns(table.schema(), layout, memory.data(), 0, num_rows, columns);
+
+            for (const std::vector<std::size_t> &attrs : { std::vector<std::size_t>{ 0, 1, 2, 3 },
+                                                           std::vector<std::size_t>{ 0, 3 } })
+            {
+                CHECK((ScanKernelRegistry::Get().find(layout, attrs) != nullptr) == is_generated);
+
+                /* Scan a range that starts and ends within blocks. */
+                const std::size_t first_row = 3, n = num_rows - 10;
+                std::vector<std::vector<int32_t>> outputs(attrs.size(), std::vector<int32_t>(n));
+                std::vector<void*> output_ptrs;
+                for (auto &output : outputs)
+                    output_ptrs.push_back(output.data());
+                CHECK(scan_columns(table.schema(), layout, memory.data(), first_row, n, attrs, output_ptrs.data()) ==
+                      is_generated);
+                for (std::size_t k = 0; k != attrs.size(); ++k)
+                    CHECK(std::equal(outputs[k].begin(), outputs[k].end(), values[attrs[k]].begin() + first_row));
+
+                /* The fallback reads the same values. */
+                for (auto &output : outputs)
+                    std::fill(output.begin(), output.end(), 0);
+                read_columns(table.schema(), layout, memory.data(), first_row, n, attrs, output_ptrs.data());
+                for (std::size_t k = 0; k != attrs.size(); ++k)
+                    CHECK(std::equal(outputs[k].begin(), outputs[k].end(), values[attrs[k]].begin() + first_row));
+
+                /* So does the prefetching scan, for any distance. */
+                for (std::size_t distance : { 0, 1, 7, 64, 5000 }) {
+                    for (auto &output : outputs)
+                        std::fill(output.begin(), output.end(), 0);
+                    read_columns_prefetched(table.schema(), layout, memory.data(), first_row, n, attrs,
+                                            output_ptrs.data(), distance);
+                    for (std::size_t k = 0; k != attrs.size(); ++k)
+                        CHECK(std::equal(outputs[k].begin(), outputs[k].end(), values[attrs[k]].begin() + first_row));
+                }
+            }
+        }
+    }
+
+    SECTION("unsupported attributes")
+    {
+        table.push_back(C.pool("flag"), m::Type::Get_Boolean(m::Type::TY_Vector));
+        std::unique_ptr<DataLayoutFactory> factory = std::make_unique<MyPAX4kLayoutFactory>();
+        CHECK_NOTHROW(generate_scan_kernel(table.schema(), factory->make(table.schema()), { 0, 1 }, "PAX4k"));
+        CHECK_THROWS_AS(generate_scan_kernel(table.schema(), factory->make(table.schema()), { 0, 4 }, "PAX4k"),
+                        std::invalid_argument);
+        int32_t key;
+        bool flag;
+        void *outputs[] = { &key, &flag };
+        CHECK_THROWS_AS(read_columns_prefetched(table.schema(), factory->make(table.schema()), &key, 0, 1,
+                                                { 0, 4 }, outputs, 8),
+                        std::invalid_argument);
+    }
+}
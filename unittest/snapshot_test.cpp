@@ -0,0 +1,97 @@
+#include <catch2/catch.hpp>
+
+#include "data_layouts.hpp"
+#include "snapshot.hpp"
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <sys/mman.h>
+
+
+using namespace m;
+using namespace m::storage;
+
+
+TEST_CASE("snapshot", "[milestone1]")
+{
+    Catalog::Clear(); // drop all data
+    auto &C = m::Catalog::Get();
+
+    auto &DB = C.add_database(C.pool("test_db"));
+    auto &table = DB.add_table(C.pool("test"));
+    table.push_back(C.pool("a_i4"), m::Type::Get_Integer(m::Type::TY_Vector, 4));
+    table.push_back(C.pool("b_c5"), m::Type::Get_Char(m::Type::TY_Vector, 5));
+    table.push_back(C.pool("c_i8"), m::Type::Get_Integer(m::Type::TY_Vector, 8));
+
+    std::unique_ptr<DataLayoutFactory> pax = std::make_unique<MyPAX4kLayoutFactory>();
+    std::unique_ptr<DataLayoutFactory> row = std::make_unique<MyOptimizedRowLayoutFactory>();
+    auto layout = pax->make(table.schema());
+    CHECK(layout_fingerprint(layout) == layout_fingerprint(pax->make(table.schema())));
+    CHECK(layout_fingerprint(layout) != layout_fingerprint(row->make(table.schema())));
+
+    /* Fill three and a half blocks with a pattern. */
+    const std::size_t num_rows = 3 * layout.child().num_tuples() + layout.child().num_tuples() / 2;
+    const std::size_t size = snapshot_data_size(layout, num_rows);
+    CHECK(size == 4 * 4096);
+    std::vector<uint8_t> data(size);
+    for (std::size_t i = 0; i != size; ++i)
+        data[i] = i * 7 + i / 4096;
+
+    const auto path = std::filesystem::temp_directory_path() / "dbsys22_snapshot_test.snap";
+    write_snapshot(path, table.schema(), layout, num_rows, data.data());
+
+    /* Read the snapshot into page-aligned and unaligned memory. */
+    const std::size_t memory_size = 8 * 4096;
+    void *memory = mmap(nullptr, memory_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    REQUIRE(memory != MAP_FAILED);
+    auto bytes = static_cast<uint8_t*>(memory);
+    for (void *target : { memory, static_cast<void*>(bytes + 8) }) {
+        std::memset(memory, 0, memory_size);
+        CHECK(read_snapshot(path, table.schema(), layout, target, memory_size - 8) == num_rows);
+        CHECK(std::memcmp(target, data.data(), size) == 0);
+    }
+
+    SECTION("stale snapshots are rejected")
+    {
+        auto row_layout = row->make(table.schema());
+        CHECK_THROWS_AS(read_snapshot(path, table.schema(), row_layout, memory, memory_size), std::runtime_error);
+
+        table.push_back(C.pool("d_i4"), m::Type::Get_Integer(m::Type::TY_Vector, 4));
+        CHECK_THROWS_AS(read_snapshot(path, table.schema(), pax->make(table.schema()), memory, memory_size),
+                        std::runtime_error);
+    }
+
+    SECTION("corrupted snapshots are rejected")
+    {
+        {
+            std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+            file.seekp(-1, std::ios::end);
+            file.put(0x55); // in the padding
+            file.seekp(4096 + 100);
+            file.put(~data[100]);
+        }
+        CHECK_THROWS_AS(read_snapshot(path, table.schema(), layout, memory, memory_size), std::runtime_error);
+        /* Rejected blocks do not linger in the memory. */
+        CHECK(std::all_of(bytes, bytes + size, [](uint8_t b) { return b == 0; }));
+        CHECK(read_snapshot(path, table.schema(), layout, memory, memory_size, false) == num_rows);
+    }
+
+    SECTION("files of another version are rejected")
+    {
+        {
+            std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+            file.seekp(offsetof(snapshot_header, version));
+            file.put(snapshot_header::VERSION + 1);
+        }
+        CHECK_THROWS_AS(read_snapshot(path, table.schema(), layout, memory, memory_size), std::runtime_error);
+    }
+
+    SECTION("snapshots must fit into the memory")
+    {
+        CHECK_THROWS_AS(read_snapshot(path, table.schema(), layout, memory, size - 1), std::runtime_error);
+    }
+
+    munmap(memory, memory_size);
+    std::filesystem::remove(path);
+}
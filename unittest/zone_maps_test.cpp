@@ -0,0 +1,110 @@
+#include <catch2/catch.hpp>
+
+#include "zone_maps.hpp"
+#include <cstring>
+#include <vector>
+
+
+using namespace m;
+using namespace m::storage;
+
+
+TEST_CASE("ZoneMaps", "[milestone1]")
+{
+    Catalog::Clear(); // drop all data
+    auto &C = m::Catalog::Get();
+
+    auto &DB = C.add_database(C.pool("test_db"));
+    auto &table = DB.add_table(C.pool("test"));
+    table.push_back(C.pool("a_c3"), m::Type::Get_Char(m::Type::TY_Vector, 3));
+    table.push_back(C.pool("b_i4"), m::Type::Get_Integer(m::Type::TY_Vector, 4));
+    table.push_back(C.pool("c_d"),  m::Type::Get_Double(m::Type::TY_Vector));
+    table.push_back(C.pool("d_n9"), m::Type::Get_Decimal(m::Type::TY_Vector, 9, 2));
+
+    std::unique_ptr<DataLayoutFactory> factory = std::make_unique<MyPAXZoneMapLayoutFactory>(512);
+    auto layout = factory->make(table.schema());
+
+    /* The header holds the synopses of `b_i4`, `c_d`, and `d_n9`. */
+    auto block = cast<const DataLayout::INode>(&layout.child());
+    REQUIRE(block);
+    const std::size_t tuples_per_block = block->num_tuples();
+    CHECK(tuples_per_block == (512 * 8 - 3 * 192) / (64 + 32 + 32 + 24 + 4));
+    for (std::size_t i = 0; i != block->num_children(); ++i)
+        CHECK(block->at(i).offset_in_bits >= 3 * MyPAXZoneMapLayoutFactory::SYNOPSIS_SIZE_IN_BITS);
+
+    /* Write tuples to the blocks like mutable would: `b_i4` is the row index, times 10 from the third block on,
+     * `c_d` is NULL in every odd row, `d_n9` is the negated row index plus a quarter, scaled by 100. */
+    const std::size_t num_rows = 3 * tuples_per_block + 5;
+    std::vector<uint64_t> memory(4 * 512 / sizeof(uint64_t));
+    auto bytes = reinterpret_cast<uint8_t*>(memory.data());
+    ZoneMaps Z(table.schema(), layout, memory.data());
+    REQUIRE(Z.tuples_per_block() == tuples_per_block);
+    for (std::size_t row = 0; row != num_rows; ++row) {
+        uint8_t *block_addr = bytes + (row / tuples_per_block) * 512;
+        const std::size_t i = row % tuples_per_block;
+        for (std::size_t c = 0; c != block->num_children(); ++c) {
+            auto &child = block->at(c);
+            auto leaf = as<const DataLayout::Leaf>(child.ptr.get());
+            const uint64_t bit = child.offset_in_bits + i * child.stride_in_bits;
+            if (leaf->index() == 1) {
+                const int32_t value = row < 2 * tuples_per_block ? row : 10 * row;
+                std::memcpy(block_addr + bit / 8, &value, sizeof(value));
+            } else if (leaf->index() == 2) {
+                const double value = row * .5;
+                std::memcpy(block_addr + bit / 8, &value, sizeof(value));
+            } else if (leaf->index() == 3) {
+                const int32_t value = -(int32_t(row) * 100 + 25);
+                std::memcpy(block_addr + bit / 8, &value, sizeof(value));
+            } else if (leaf->index() == 4 and row % 2) {
+                block_addr[(bit + 2) / 8] |= 1 << ((bit + 2) % 8);
+            }
+        }
+        Z.update(row);
+    }
+
+    SECTION("synopses")
+    {
+        CHECK(Z.num_blocks(num_rows) == 4);
+        CHECK(Z.at(0, 1).min.i == 0);
+        CHECK(Z.at(0, 1).max.i == int64_t(tuples_per_block - 1));
+        CHECK(Z.at(0, 1).null_count == 0);
+        CHECK(Z.at(2, 1).min.i == int64_t(20 * tuples_per_block));
+        CHECK(Z.at(3, 1).max.i == int64_t(10 * (num_rows - 1)));
+        CHECK(Z.at(3, 2).min.d == 3 * tuples_per_block * .5);
+        CHECK(Z.at(3, 2).null_count == 2);
+        CHECK(Z.is_null(1, 2));
+        CHECK_FALSE(Z.is_null(1, 1));
+        CHECK(Z.get_integer(5, 1) == 5);
+        CHECK(Z.get_double(5, 2) == 2.5);
+        CHECK(Z.at(1, 3).min.i == -int64_t((2 * tuples_per_block - 1) * 100 + 25));
+        CHECK(Z.at(1, 3).max.i == -int64_t(tuples_per_block * 100 + 25));
+        CHECK(Z.get_integer(5, 3) == -525);
+    }
+
+    SECTION("scan skips blocks")
+    {
+        std::vector<std::size_t> rows;
+        const int64_t lo = 20 * tuples_per_block;
+        auto stats = Z.scan(1, lo, lo + 10, num_rows, [&rows](std::size_t row) { rows.push_back(row); });
+        CHECK(stats.num_blocks == 4);
+        CHECK(stats.num_skipped == 3);
+        CHECK(rows == std::vector<std::size_t>{ 2 * tuples_per_block, 2 * tuples_per_block + 1 });
+    }
+
+    SECTION("scan skips NULL values")
+    {
+        std::vector<std::size_t> rows;
+        auto stats = Z.scan(2, 0., 2., num_rows, [&rows](std::size_t row) { rows.push_back(row); });
+        CHECK(stats.num_skipped == 3);
+        CHECK(rows == std::vector<std::size_t>{ 0, 2, 4 });
+    }
+
+    SECTION("scan decimals")
+    {
+        std::vector<std::size_t> rows;
+        const int64_t hi = -int64_t(tuples_per_block * 100 + 25);
+        auto stats = Z.scan(3, hi - 100, hi, num_rows, [&rows](std::size_t row) { rows.push_back(row); });
+        CHECK(stats.num_skipped == 3);
+        CHECK(rows == std::vector<std::size_t>{ tuples_per_block, tuples_per_block + 1 });
+    }
+}